@@ -0,0 +1,200 @@
+// Headless batch analyzer: deals or loads positions, solves them on every
+// core and writes one CSV line per deal plus a summary of throughput and
+// win rate.
+//
+//     Analyzer [--first D] [--deals N] [--threads T] [--nodes N] [--seconds S] [--csv FILE]
+//              [--external DIR [--memory MB]] [save files...]
+//
+// Save files are read with Field::load_from_file; one that cannot be read gets
+// an "error" line and is left out of the summary. Without any, deal numbers
+// D to D + N - 1 are analyzed, so every line can be replayed with Field(D).
+//
+// --external switches to ExternalSolver for deals too large for a table in
+// RAM. Each thread spills to its own subdirectory of DIR and gets an equal
+// share of the MB budget; solutions are not kept, so moves reads 0.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "external_solver.h"
+#include "field.h"
+#include "solver.h"
+
+struct AnalyzerOptions {
+    std::uint64_t first_deal = 0;
+    std::uint64_t deals = 1000;
+    int threads = 0;
+    SolverLimits limits = {.max_nodes = 2'000'000, .max_seconds = 10.0, .weights = {}};
+    std::string csv_path = "analysis.csv";
+    std::string external_path;
+    std::size_t memory_mb = 1024;
+    std::vector<std::string> files;
+};
+
+struct AnalyzerTotals {
+    std::atomic<std::uint64_t> solved = 0;
+    std::atomic<std::uint64_t> unsolvable = 0;
+    std::atomic<std::uint64_t> timeout = 0;
+    std::atomic<std::uint64_t> solution_moves = 0;
+    std::atomic<std::uint64_t> nodes = 0;
+    std::atomic<std::uint64_t> errors = 0;
+};
+
+static void print_usage() {
+    std::cerr << "usage: Analyzer [--first D] [--deals N] [--threads T] [--nodes N] [--seconds S] [--csv FILE]\n"
+              << "                [--external DIR [--memory MB]] [save files...]\n";
+}
+
+static bool parse_options(int argc, char *argv[], AnalyzerOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--first" && has_value) {
+            options.first_deal = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--deals" && has_value) {
+            options.deals = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--nodes" && has_value) {
+            options.limits.max_nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seconds" && has_value) {
+            options.limits.max_seconds = std::atof(argv[++i]);
+        } else if (arg == "--csv" && has_value) {
+            options.csv_path = argv[++i];
+        } else if (arg == "--external" && has_value) {
+            options.external_path = argv[++i];
+        } else if (arg == "--memory" && has_value) {
+            options.memory_mb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg.starts_with("--")) {
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    if (!options.files.empty()) {
+        options.deals = options.files.size();
+    }
+    if (options.threads <= 0) {
+        options.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    return true;
+}
+
+static const char *status_name(SolveStatus status) {
+    switch (status) {
+    case SolveStatus::solved:
+        return "solved";
+    case SolveStatus::unsolvable:
+        return "unsolvable";
+    case SolveStatus::timeout:
+        return "timeout";
+    }
+    return "";
+}
+
+int main(int argc, char *argv[]) {
+    AnalyzerOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    std::ofstream csv(options.csv_path);
+    if (!csv) {
+        std::cerr << "ERROR: Cannot write \"" << options.csv_path << "\"\n";
+        return 1;
+    }
+    csv << "deal,source,status,moves,nodes,seconds\n";
+
+    std::atomic<std::uint64_t> next_deal = 0;
+    std::mutex csv_mutex;
+    AnalyzerTotals totals;
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<int> next_thread = 0;
+    auto work = [&]() {
+        // One table per thread keeps the workers independent; 2^18 buckets is
+        // 8 MiB, plenty for the default node limit.
+        Solver solver(options.limits, 18);
+        ExternalSolver external({
+            .max_nodes = options.limits.max_nodes,
+            .max_seconds = options.limits.max_seconds,
+            .memory_budget = (options.memory_mb << 20) / options.threads,
+            .directory = std::filesystem::path(options.external_path) / std::to_string(next_thread++),
+        });
+        Field field{empty_board};
+        for (std::uint64_t deal = next_deal++; deal < options.deals; deal = next_deal++) {
+            std::string source = "deal";
+            if (options.files.empty()) {
+                field.deal(options.first_deal + deal);
+            } else {
+                source = options.files[deal];
+                if (!field.load_from_file(source)) {
+                    // Reported but kept out of the totals.
+                    totals.errors++;
+                    std::lock_guard lock(csv_mutex);
+                    std::cerr << "ERROR: Cannot read \"" << source << "\"\n";
+                    csv << deal << ',' << source << ",error,0,0,0\n";
+                    continue;
+                }
+            }
+
+            SolveResult result = options.external_path.empty() ? solver.solve(field) : external.solve(field);
+            switch (result.status) {
+            case SolveStatus::solved:
+                totals.solved++;
+                totals.solution_moves += result.solution.size();
+                break;
+            case SolveStatus::unsolvable:
+                totals.unsolvable++;
+                break;
+            case SolveStatus::timeout:
+                totals.timeout++;
+                break;
+            }
+            totals.nodes += result.nodes;
+
+            std::lock_guard lock(csv_mutex);
+            csv << (options.files.empty() ? options.first_deal + deal : deal) << ',' << source << ',' << status_name(result.status) << ','
+                << result.solution.size() << ',' << result.nodes << ','
+                << std::fixed << std::setprecision(4) << result.seconds << '\n';
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.threads; i++) {
+        threads.emplace_back(work);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t solved = totals.solved;
+    std::uint64_t decided = solved + totals.unsolvable;
+    std::uint64_t total = decided + totals.timeout;
+
+    // Timeouts count as losses for the lower bound and as wins for the upper.
+    std::cout << std::fixed << std::setprecision(2)
+              << "deals:        " << total << " (" << options.threads << " threads, " << seconds << " s)\n"
+              << "solved:       " << solved << '\n'
+              << "unsolvable:   " << totals.unsolvable << '\n'
+              << "timeout:      " << totals.timeout << '\n'
+              << "errors:       " << totals.errors << '\n'
+              << "win rate:     " << (decided ? 100.0 * solved / decided : 0.0) << "% of decided, "
+              << (total ? 100.0 * solved / total : 0.0) << "% to "
+              << (total ? 100.0 * (solved + totals.timeout) / total : 0.0) << "% overall\n"
+              << "mean moves:   " << (solved ? double(totals.solution_moves) / solved : 0.0) << '\n'
+              << "throughput:   " << total / std::max(seconds, 1e-9) << " deals/s, "
+              << std::setprecision(0) << totals.nodes / std::max(seconds, 1e-9) << " nodes/s\n";
+    return 0;
+}
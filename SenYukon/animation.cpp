@@ -7,9 +7,17 @@
 #include "field.h"
 #include "sound_manager.h"
 
-static void apply_movement(Field &field, const Animation::Movement &movement) {
-    field[movement.to] = field[movement.from];
-    field[movement.from] = Card{nil};
+static void apply_movement(Animation::Grid &grid, const Animation::Movement &movement) {
+    grid[movement.to] = grid[movement.from];
+    grid[movement.from] = Card{nil};
+
+    // Moves turn over the card they uncover, so the replay does too.
+    if (movement.from >= yukon_width && movement.from < yukon_size) {
+        Card &below = grid[movement.from - yukon_width];
+        if (below.is_hidden()) {
+            below = below.show();
+        }
+    }
 }
 
 static Vector2 position_to_vector(int position) {
@@ -23,7 +31,10 @@ static Vector2 position_to_vector(int position) {
 }
 
 Animation::Animation(const Field &field, double time_frame_take)
-    : field(field), time_frame_take(time_frame_take) {
+    : time_frame_take(time_frame_take) {
+    for (int i = 0; i < static_cast<int>(grid.size()); i++) {
+        grid[i] = field[i];
+    }
     time_this_created = GetTime();
 }
 
@@ -31,14 +42,29 @@ void Animation::record_frame(Movement &&movement) {
     frames.push_back(std::move(movement));
 }
 
+// Records one frame per card lifted by `move`, as played on `field`.
+void Animation::record_move(const Field &field, Move move) {
+    int from = position_of(move.from_col, move.from_row);
+
+    if (move.kind == MoveKind::foundation) {
+        record_frame(Movement(from, yukon_size + (int)field[from].get_suit()));
+        return;
+    }
+
+    int to = position_of(move.to_col, field.height(move.to_col));
+    for (int row = move.from_row; row < field.height(move.from_col); row++) {
+        record_frame(Movement(from, to));
+        from += yukon_width;
+        to += yukon_width;
+    }
+}
+
 bool Animation::is_finished() const {
     return (GetTime() - time_this_created) >= frames.size() * time_frame_take;
 }
 
 void Animation::render() {
-    Field dummy_field{};
-
-    dummy_field = field;
+    Grid dummy_field = grid;
 
     int index = (int)((GetTime() - time_this_created) / time_frame_take);
     if (played_sound_index != index) {
@@ -64,10 +90,10 @@ void Animation::render() {
     for (int y = 0; y < yukon_height; y++) {
         for (int x = 0; x < yukon_width; x++) {
             Card target = dummy_field[x + y * raw_size];
-            std::string string = target.to_string();
+            const char *label = target.get_label();
             Color color;
 
-            if (string == "HID") {
+            if (target.is_hidden()) {
                 color = LIGHTGRAY;
             } else if (target.get_color() == SuitColor::red) {
                 color = RED;
@@ -82,15 +108,15 @@ void Animation::render() {
                 float amount = time_since_this_created;
                 amount = (time_since_this_created - (((float)index) / (1.0f / time_frame_take))) * (1.0f / time_frame_take);
                 Vector2 result = Vector2Lerp(vfrom, vto, amount);
-                DrawTextEx(GetFontDefault(), string.c_str(), result, cell_height, 1.0f, color);
+                DrawTextEx(GetFontDefault(), label, result, cell_height, 1.0f, color);
             } else {
-                DrawText(string.c_str(), x * cell_width, cell_height + y * cell_height, cell_height, color);
+                DrawText(label, x * cell_width, cell_height + y * cell_height, cell_height, color);
             }
         }
     }
 
     for (int x = 0; x < foundation_count; x++) {
-        DrawText(dummy_field[yukon_size + x].to_string().c_str(), x * cell_width, 0, cell_height, SKYBLUE);
+        DrawText(dummy_field[yukon_size + x].get_label(), x * cell_width, 0, cell_height, SKYBLUE);
     }
 }
 
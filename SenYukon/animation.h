@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "field.h"
+#include "move.h"
 
 class Animation {
     
@@ -15,8 +17,11 @@ public:
         constexpr Movement(int from, int to) : from(from), to(to) {}
     };
 
+    // Animations move single cells around, so they work on a plain grid snapshot.
+    using Grid = std::array<Card, yukon_size + foundation_count>;
+
 private:
-    Field field;
+    Grid grid;
     std::vector<Movement> frames;
     double time_this_created;
     double time_frame_take;
@@ -25,6 +30,7 @@ private:
 public:
     Animation(const Field &field, double time_frame_take);
     void record_frame(Movement &&movement);
+    void record_move(const Field &field, Move move);
     bool is_finished() const;
     void render();
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "async_chain_search.h"
+
+AsyncChainSearch::AsyncChainSearch()
+    : worker(&AsyncChainSearch::run, this) {
+}
+
+AsyncChainSearch::~AsyncChainSearch() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+        generation++;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+std::uint64_t AsyncChainSearch::request(const Field &field, int root, int max_depth) {
+    std::uint64_t id;
+    {
+        std::lock_guard lock(mutex);
+        target = field;
+        target_root = root;
+        target_max_depth = max_depth;
+        id = ++generation;
+    }
+    wake.notify_one();
+    return id;
+}
+
+// Nothing is waiting for the answer any more; a bare generation bump stops
+// the worker at its next depth.
+void AsyncChainSearch::cancel() {
+    std::lock_guard lock(mutex);
+    target_root = nil;
+    generation++;
+}
+
+void AsyncChainSearch::run() {
+    std::uint64_t handled = 0;
+    Field field{empty_board};
+    int root = nil;
+    int max_depth = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stop || generation != handled; });
+            if (stop) {
+                return;
+            }
+            handled = generation;
+            if (target_root == nil) {
+                continue;
+            }
+            field = target;
+            root = target_root;
+            max_depth = target_max_depth;
+        }
+
+        if (!board.is_built_for(field)) {
+            board.build(field);
+        }
+
+        // One search per depth limit. Each is bounded by the chains it
+        // returns, so redoing the shallow part costs little next to showing
+        // the short chains a frame earlier.
+        for (int depth = 1; depth <= max_depth && !is_cancelled(handled); depth++) {
+            ChainSnapshot &snapshot = snapshots.write_buffer();
+            snapshot.request = handled;
+            snapshot.graph.build(board, root, depth);
+            snapshot.depth = depth;
+            snapshot.complete = depth == max_depth;
+            snapshots.publish();
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "chain_graph.h"
+#include "field.h"
+#include "triple_buffer.h"
+
+struct ChainSnapshot {
+    // Which request this answers; 0 before the first one.
+    std::uint64_t request = 0;
+    int depth = 0;
+    bool complete = false;
+    ChainGraph graph;
+};
+
+// Runs the chain search for the cursor on a worker thread. Each request
+// supersedes the previous one, which the worker abandons at its next depth.
+// Results are published through a triple buffer after every depth, so the
+// render thread picks up a growing overlay without ever taking a lock.
+class AsyncChainSearch {
+public:
+    AsyncChainSearch();
+    ~AsyncChainSearch();
+
+    AsyncChainSearch(const AsyncChainSearch &) = delete;
+    AsyncChainSearch &operator=(const AsyncChainSearch &) = delete;
+
+    // Returns the id the snapshots for this request will carry.
+    std::uint64_t request(const Field &field, int root, int max_depth);
+    void cancel();
+
+    // Render thread only. The newest snapshot, which may answer an older
+    // request than the last one made.
+    const ChainSnapshot &read() {
+        return snapshots.read();
+    }
+
+private:
+    void run();
+    bool is_cancelled(std::uint64_t handled) const {
+        return generation.load(std::memory_order_relaxed) != handled;
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    Field target{empty_board};
+    int target_root = nil;
+    int target_max_depth = 0;
+    std::atomic<std::uint64_t> generation = 0;
+    bool stop = false;
+
+    // Worker only.
+    BoardChains board;
+    TripleBuffer<ChainSnapshot> snapshots;
+
+    std::thread worker;
+};
@@ -0,0 +1,48 @@
+#include <utility>
+
+#include "background_task.h"
+
+BackgroundTask::BackgroundTask()
+    : worker(&BackgroundTask::run, this) {
+}
+
+BackgroundTask::~BackgroundTask() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void BackgroundTask::start(Job job) {
+    {
+        std::lock_guard lock(mutex);
+        pending = std::move(job);
+    }
+    wake.notify_one();
+}
+
+BackgroundTask::Finish BackgroundTask::take_finished() {
+    std::lock_guard lock(mutex);
+    return std::exchange(finished, nullptr);
+}
+
+void BackgroundTask::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stop || pending; });
+            if (stop) {
+                return;
+            }
+            job = std::exchange(pending, nullptr);
+        }
+
+        Finish finish = job();
+
+        std::lock_guard lock(mutex);
+        finished = std::move(finish);
+    }
+}
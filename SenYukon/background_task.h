@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs one slow button action at a time on a worker thread, so the window
+// keeps drawing while it searches. A job does its search on the worker and
+// returns what to do with the result; that part is handed back through
+// take_finished() and run on the UI thread, so only the UI thread changes
+// the game. The job itself must not touch anything the UI thread uses in
+// the meantime.
+//
+// A running job is not interrupted; the destructor waits for it, which the
+// buttons' time limits keep short.
+class BackgroundTask {
+public:
+    using Finish = std::function<void()>;
+    using Job = std::function<Finish()>;
+
+    BackgroundTask();
+    ~BackgroundTask();
+
+    BackgroundTask(const BackgroundTask &) = delete;
+    BackgroundTask &operator=(const BackgroundTask &) = delete;
+
+    // UI thread only, and not again until the job has been taken back.
+    void start(Job job);
+    // The finished job's result handler, handed out once; empty while the
+    // job is still running.
+    Finish take_finished();
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    Job pending;
+    Finish finished;
+    bool stop = false;
+
+    std::thread worker;
+};
@@ -0,0 +1,35 @@
+#include "belief_state.h"
+
+BeliefState::BeliefState(const Field &field) {
+    reset(field);
+}
+
+void BeliefState::reset(const Field &field) {
+    unseen = 0;
+    seen = {};
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < field.hidden_count(col); row++) {
+            unseen |= card_bit(field.at(col, row));
+        }
+    }
+}
+
+// make() turns over the card the moved range sat on.
+void BeliefState::apply(const Field &field, const Undo &undo) {
+    if (!undo.revealed) {
+        return;
+    }
+    int col = undo.move.from_col;
+    int row = undo.move.from_row - 1;
+    unseen &= ~card_bit(field.at(col, row));
+    seen[col][row] = Card{nil};
+}
+
+void BeliefState::retract(const Field &field, const Undo &undo) {
+    if (!undo.revealed) {
+        return;
+    }
+    int col = undo.move.from_col;
+    int row = undo.move.from_row - 1;
+    seen[col][row] = field.at(col, row).show();
+}
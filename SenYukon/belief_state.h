@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "card.h"
+#include "field.h"
+#include "move.h"
+
+// One bit per card, indexed by the face-up raw value.
+using CardMask = std::uint64_t;
+
+inline CardMask card_bit(Card card) {
+    return CardMask{1} << card.show().get_raw();
+}
+
+// What the player can know about the face-down cards. Cards that were never
+// face up could be under any face-down slot whose card has not been seen. A
+// slot that was turned over and then covered again by an undo holds the
+// card the player saw there.
+//
+// Face-down cards never move, so the state is a mask of unseen cards plus
+// the card seen at each slot. apply() and retract() are O(1) per move; only
+// reset() walks the field.
+class BeliefState {
+    CardMask unseen = 0;
+    std::array<std::array<Card, yukon_height>, yukon_width> seen = {};
+
+public:
+    BeliefState() = default;
+    explicit BeliefState(const Field &field);
+    void reset(const Field &field);
+
+    // Call after field.make(move) returned `undo`.
+    void apply(const Field &field, const Undo &undo);
+    // Call after field.unmake(undo).
+    void retract(const Field &field, const Undo &undo);
+
+    // Cards that could be at a face-down slot.
+    CardMask candidates(int col, int row) const {
+        Card card = seen[static_cast<size_t>(col)][static_cast<size_t>(row)];
+        return card.is_nil() ? unseen : card_bit(card);
+    }
+
+    // The card the player saw at a face-down slot, or nil.
+    Card seen_card(int col, int row) const {
+        return seen[static_cast<size_t>(col)][static_cast<size_t>(row)];
+    }
+
+    CardMask get_unseen() const {
+        return unseen;
+    }
+};
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <memory>
+
+#include "canonical.h"
+#include "field.h"
+#include "rng.h"
+
+namespace {
+
+// Indexed by the original suit.
+constexpr std::array<std::array<int, suit_count>, suit_map_count> suit_maps = {{
+    {0, 1, 2, 3},
+    {0, 2, 1, 3},
+    {3, 1, 2, 0},
+    {3, 2, 1, 0},
+}};
+
+static_assert(static_cast<int>(Suit::spade) == 0 && static_cast<int>(Suit::club) == 3);
+static_assert(static_cast<int>(Suit::heart) == 1 && static_cast<int>(Suit::diamond) == 2);
+
+struct CanonicalKeys {
+    std::array<std::array<SuitMapHashes, hidden>, yukon_height> cells;
+    std::array<SuitMapHashes, yukon_height + 1> hidden_counts;
+    std::array<std::array<std::uint64_t, pips_per_suit + 1>, foundation_count> foundations;
+};
+
+CanonicalKeys make_canonical_keys() {
+    auto keys = std::make_unique<CanonicalKeys>();
+    FastRng rng{0xC4A0'11CA'15ED'7A3B};
+
+    // Draw one key per (row, card), then spread it to the cards it stands
+    // for under each suit map.
+    for (auto &row : keys->cells) {
+        std::array<std::uint64_t, hidden> base;
+        for (auto &key : base) {
+            key = rng.next();
+        }
+        for (int card = 0; card < hidden; card++) {
+            int suit = card / pips_per_suit;
+            int pip_index = card % pips_per_suit;
+            for (int map = 0; map < suit_map_count; map++) {
+                row[card][map] = base[suit_maps[map][suit] * pips_per_suit + pip_index];
+            }
+        }
+    }
+    for (auto &count : keys->hidden_counts) {
+        count.fill(rng.next());
+    }
+    keys->hidden_counts[0].fill(0);
+    for (auto &suit : keys->foundations) {
+        for (auto &key : suit) {
+            key = rng.next();
+        }
+    }
+    return *keys;
+}
+
+const CanonicalKeys canonical_keys = make_canonical_keys();
+
+std::uint64_t mix(std::uint64_t h) {
+    h = (h ^ (h >> 33)) * 0xFF51'AFD7'ED55'8CCD;
+    h = (h ^ (h >> 33)) * 0xC4CE'B9FE'1A85'EC53;
+    return h ^ (h >> 33);
+}
+
+} // namespace
+
+const SuitMapHashes &canonical_cell_keys(int row, Card card) {
+    return canonical_keys.cells[row][card.show().get_raw()];
+}
+
+const SuitMapHashes &canonical_hidden_keys(int count) {
+    return canonical_keys.hidden_counts[count];
+}
+
+std::uint64_t canonical_hash(const Field &field) {
+    std::uint64_t best = ~std::uint64_t{0};
+    for (int map = 0; map < suit_map_count; map++) {
+        std::array<std::uint64_t, yukon_width> columns;
+        for (int col = 0; col < yukon_width; col++) {
+            columns[col] = field.get_column_hashes(col)[map];
+        }
+        std::sort(columns.begin(), columns.end());
+
+        std::uint64_t h = 0;
+        for (int suit = 0; suit < foundation_count; suit++) {
+            h ^= canonical_keys.foundations[suit_maps[map][suit]][field.foundation(suit).get_pip()];
+        }
+        for (std::uint64_t column_hash : columns) {
+            h = mix(h + column_hash);
+        }
+        best = std::min(best, h);
+    }
+    return best;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "card.h"
+
+class Field;
+
+// Suit relabelings that keep colours: identity, reds swapped, blacks swapped,
+// both swapped.
+inline constexpr int suit_map_count = 4;
+
+using SuitMapHashes = std::array<std::uint64_t, suit_map_count>;
+
+// Keys for one column under every suit map. They depend on row and card but
+// not on the column, so equal columns hash equally wherever they stand. Field
+// folds them into per-column hashes as cards move; zero hidden cards has the
+// zero key, so an empty column hashes to zero.
+const SuitMapHashes &canonical_cell_keys(int row, Card card);
+const SuitMapHashes &canonical_hidden_keys(int count);
+
+// Hash shared by every position that plays out the same as `field`: columns
+// may come in any order, and the two red suits as well as the two black
+// suits may trade places throughout the tableau and foundations.
+std::uint64_t canonical_hash(const Field &field);
@@ -1,20 +1,83 @@
 #pragma once
 
-#include <string>
+#include <array>
+#include <cstdint>
 
 #include "util.h"
 #include "defs.h"
 
+struct CardInfo {
+    int pip;
+    Suit suit;
+    SuitColor color;
+    const char *label;
+};
+
+namespace card_tables {
+
+constexpr SuitColor color_of(Suit suit) {
+    switch (suit) {
+    case Suit::heart:
+    case Suit::diamond:
+        return SuitColor::red;
+    case Suit::spade:
+    case Suit::club:
+        return SuitColor::black;
+    }
+    return SuitColor::black;
+}
+
+constexpr std::array<std::array<char, 4>, hidden> make_labels() {
+    constexpr char suit_chars[suit_count] = {'S', 'H', 'D', 'C'};
+    constexpr const char *pip_strings[pips_per_suit] = {"A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K"};
+
+    std::array<std::array<char, 4>, hidden> labels = {};
+    for (int i = 0; i < hidden; i++) {
+        labels[i][0] = suit_chars[i / pips_per_suit];
+        const char *pip = pip_strings[i % pips_per_suit];
+        for (int j = 0; pip[j]; j++) {
+            labels[i][j + 1] = pip[j];
+        }
+    }
+    return labels;
+}
+
+inline constexpr auto labels = make_labels();
+
+// Indexed by raw value + 1 so nil lands on the first entry.
+constexpr std::array<CardInfo, card_max + 2> make_infos() {
+    std::array<CardInfo, card_max + 2> infos = {};
+    infos[0] = CardInfo{0, Suit::spade, SuitColor::black, ""};
+    for (int raw = card_min; raw <= card_max; raw++) {
+        int shown = raw % hidden;
+        Suit suit = static_cast<Suit>(shown / pips_per_suit);
+        infos[raw + 1] = CardInfo{
+            shown % pips_per_suit + 1,
+            suit,
+            color_of(suit),
+            raw >= hidden ? "HID" : labels[shown].data(),
+        };
+    }
+    return infos;
+}
+
+} // namespace card_tables
+
+inline constexpr auto card_infos = card_tables::make_infos();
+
 class Card {
-    int internal = nil;
+    // Raw values fit in a byte, so a whole column of cards is a single cache line.
+    std::int8_t internal = nil;
 
 public:
     Card() = default;
 
     explicit Card(int source)
-        : internal{source} {
+        : internal{static_cast<std::int8_t>(source)} {
     }
 
+    bool operator==(const Card &) const = default;
+
     int get_raw() const {
         return internal;
     }
@@ -35,83 +98,24 @@ public:
         return Card{internal / hidden ? internal : internal + hidden};
     }
 
+    const CardInfo &get_info() const {
+        return card_infos[internal + 1];
+    }
+
     int get_pip() const {
-        return (show().internal % pips_per_suit) + 1;
+        return get_info().pip;
     }
 
     Suit get_suit() const {
-        return static_cast<Suit>(show().internal / pips_per_suit);
+        return get_info().suit;
     }
 
     SuitColor get_color() const {
-        switch (get_suit()) {
-        case Suit::heart:
-        case Suit::diamond:
-            return SuitColor::red;
-        case Suit::spade:
-        case Suit::club:
-            return SuitColor::black;
-        }
-        SEN_UNREACHABLE();
+        return get_info().color;
     }
 
-    std::string to_string() const {
-        std::string suit_string = {};
-        std::string pip_string = {};
-        
-
-        if (is_nil()) {
-            return "";
-        }
-        if (is_hidden()) {
-            return "HID";
-        }
-        switch (get_suit()) {
-        case Suit::spade:
-            suit_string = "S";
-            break;
-        case Suit::heart:
-            suit_string = "H";
-            break;
-        case Suit::diamond:
-            suit_string = "D";
-            break;
-        case Suit::club:
-            suit_string = "C";
-            break;
-        default:
-            suit_string = "?";
-            break;
-        }
-        switch (get_pip()) {
-        case 1:
-            pip_string = "A";
-            break;
-        case 2:
-        case 3:
-        case 4:
-        case 5:
-        case 6:
-        case 7:
-        case 8:
-        case 9:
-        case 10:
-            pip_string = std::to_string(get_pip());
-            break;
-        case 11:
-            pip_string = "J";
-            break;
-        case 12:
-            pip_string = "Q";
-            break;
-        case 13:
-            pip_string = "K";
-            break;
-        default:
-            pip_string = "?";
-            break;
-        }
-
-        return suit_string + pip_string;
+    // Static string: "" for nil, "HID" for face-down cards, otherwise suit and pip.
+    const char *get_label() const {
+        return get_info().label;
     }
 };
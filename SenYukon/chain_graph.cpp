@@ -0,0 +1,155 @@
+#include <algorithm>
+
+#include "chain_graph.h"
+
+int chain_successors(const Field &field, int position, std::array<int, yukon_width> &successors) {
+    Card card = field[position];
+    if (card.is_nil() || card.is_hidden()) {
+        return 0;
+    }
+
+    int count = 0;
+    if (card.get_pip() == pip_king) {
+        // Already at the bottom of its column.
+        if (row_of(position) == 0) {
+            return 0;
+        }
+        for (int col = 0; col < yukon_width; col++) {
+            Card bottom = field.at(col, 0);
+            if (!bottom.is_hidden() && bottom.get_pip() != pip_king) {
+                successors[count++] = col;
+            }
+        }
+        return count;
+    }
+
+    for (int target : field.find(card.get_pip() + 1, card.get_color().opposite())) {
+        if (!field.is_face_up(target)) {
+            continue;
+        }
+        if (column_of(target) == column_of(position)) {
+            if (field.is_front(target)) {
+                successors[count++] = target;
+            }
+        } else if (target + yukon_width < yukon_size) {
+            successors[count++] = target + yukon_width;
+        }
+    }
+    return count;
+}
+
+void BoardChains::build(const Field &field) {
+    std::array<int, yukon_width> found;
+    int edge_count = 0;
+    for (int position = 0; position < yukon_size; position++) {
+        firsts[position] = static_cast<std::int16_t>(edge_count);
+        int count = chain_successors(field, position, found);
+        for (int i = 0; i < count; i++) {
+            targets[edge_count++] = static_cast<std::int16_t>(found[i]);
+        }
+    }
+    firsts[yukon_size] = static_cast<std::int16_t>(edge_count);
+
+    // Distances come from a breadth-first search backwards from every empty
+    // slot, over the edges reversed into a second flat array.
+    std::array<std::int16_t, yukon_size + 1> reverse_firsts = {};
+    std::array<std::int16_t, max_edges> sources;
+    for (int i = 0; i < edge_count; i++) {
+        reverse_firsts[targets[i] + 1]++;
+    }
+    for (int position = 0; position < yukon_size; position++) {
+        reverse_firsts[position + 1] = static_cast<std::int16_t>(reverse_firsts[position + 1] + reverse_firsts[position]);
+    }
+    std::array<std::int16_t, yukon_size> fill = {};
+    for (int position = 0; position < yukon_size; position++) {
+        for (int i = firsts[position]; i < firsts[position + 1]; i++) {
+            int target = targets[i];
+            sources[reverse_firsts[target] + fill[target]++] = static_cast<std::int16_t>(position);
+        }
+    }
+
+    std::array<std::int16_t, yukon_size> queue;
+    int queue_size = 0;
+    distances.fill(nil);
+    for (int position = 0; position < yukon_size; position++) {
+        if (field[position].is_nil()) {
+            distances[position] = 0;
+            queue[queue_size++] = static_cast<std::int16_t>(position);
+        }
+    }
+    for (int i = 0; i < queue_size; i++) {
+        int to = queue[i];
+        for (int j = reverse_firsts[to]; j < reverse_firsts[to + 1]; j++) {
+            int from = sources[j];
+            if (distances[from] == nil) {
+                distances[from] = static_cast<std::int16_t>(distances[to] + 1);
+                queue[queue_size++] = static_cast<std::int16_t>(from);
+            }
+        }
+    }
+
+    hash = field.get_hash();
+    built = true;
+}
+
+ChainGraph::ChainGraph() {
+    depths.fill(nil);
+}
+
+void ChainGraph::clear() {
+    for (int i = 0; i < position_count; i++) {
+        depths[order[i]] = nil;
+        useful[order[i]] = false;
+    }
+    root = nil;
+    position_count = 0;
+    edge_count = 0;
+    max_depth_reached = 0;
+}
+
+void ChainGraph::build(const BoardChains &board, int root_position, int max_depth) {
+    clear();
+    root = root_position;
+
+    depths[root] = 0;
+    order[position_count++] = static_cast<std::int16_t>(root);
+    for (int i = 0; i < position_count; i++) {
+        int from = order[i];
+        int depth = depths[from] + 1;
+        if (depth > max_depth) {
+            break;
+        }
+
+        for (int to : board.successors(from)) {
+            int distance = board.distance(to);
+            if (distance == nil || depth + distance > max_depth) {
+                continue;
+            }
+            if (depths[to] == nil) {
+                depths[to] = static_cast<std::int16_t>(depth);
+                order[position_count++] = static_cast<std::int16_t>(to);
+            }
+            if (depths[to] == depth) {
+                edges[edge_count++] = ChainEdge{static_cast<std::int16_t>(from), static_cast<std::int16_t>(to)};
+            }
+        }
+    }
+
+    // Backwards over the edges, so every position is settled before the
+    // edges leading into it are looked at.
+    for (int i = 0; i < position_count; i++) {
+        if (board.distance(order[i]) == 0) {
+            useful[order[i]] = true;
+        }
+    }
+    for (int i = edge_count - 1; i >= 0; i--) {
+        if (useful[edges[i].to]) {
+            useful[edges[i].from] = true;
+        }
+    }
+    for (int i = 0; i < position_count; i++) {
+        if (useful[order[i]]) {
+            max_depth_reached = std::max<int>(max_depth_reached, depths[order[i]]);
+        }
+    }
+}
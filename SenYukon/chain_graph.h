@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "field.h"
+
+// Every slot a card could go to directly: the slot above each card of the
+// next pip in the opposite colour, or the bottom of any column for a king.
+// Empty slots and face-down cards have no successors.
+int chain_successors(const Field &field, int position, std::array<int, yukon_width> &successors);
+
+// chain_successors for every slot of one position, plus how many steps each
+// slot is from the nearest empty slot. Built once whenever the field changes;
+// everything the chain overlay asks afterwards is a lookup.
+class BoardChains {
+public:
+    static constexpr int max_edges = yukon_size * yukon_width;
+
+    void build(const Field &field);
+
+    bool is_built_for(const Field &field) const {
+        return built && hash == field.get_hash();
+    }
+
+    std::span<const std::int16_t> successors(int position) const {
+        return {targets.data() + firsts[static_cast<size_t>(position)], static_cast<size_t>(firsts[static_cast<size_t>(position) + 1] - firsts[static_cast<size_t>(position)])};
+    }
+
+    // Steps from `position` to the nearest empty slot, 0 for an empty slot
+    // itself, or nil if no chain leads to one.
+    int distance(int position) const {
+        return distances[static_cast<size_t>(position)];
+    }
+
+private:
+    bool built = false;
+    std::uint64_t hash = 0;
+    std::array<std::int16_t, yukon_size + 1> firsts;
+    std::array<std::int16_t, max_edges> targets;
+    std::array<std::int16_t, yukon_size> distances;
+};
+
+struct ChainEdge {
+    std::int16_t from = nil;
+    std::int16_t to = nil;
+};
+
+// The chains of moves that would make room for the card at `root`: a chain
+// steps from a card to the slot it wants, and from whatever card sits in
+// that slot onwards, until it reaches an empty slot.
+//
+// Built breadth first, so every position is entered once at its shortest
+// depth and chains that meet share the rest of their way. Only edges from
+// one depth to the next are kept, which makes the graph a DAG. Slots whose
+// distance to an empty slot no longer fits in the depth limit are never
+// entered, so the search only walks the chains it returns; a backward pass
+// then drops the few that still dead-end, and clearing only touches the
+// slots the last search entered. Everything lives in fixed arrays sized by
+// the board, so the cost does not grow with the depth limit.
+class ChainGraph {
+public:
+    ChainGraph();
+    void build(const BoardChains &board, int root, int max_depth);
+    void clear();
+
+    int get_root() const {
+        return root;
+    }
+
+    // Depth at which `position` was reached, or nil.
+    int depth(int position) const {
+        return depths[static_cast<size_t>(position)];
+    }
+
+    // Whether an empty slot can be reached through `position`.
+    bool is_useful(int position) const {
+        return useful[static_cast<size_t>(position)];
+    }
+
+    // Ordered by depth.
+    std::span<const ChainEdge> get_edges() const {
+        return {edges.data(), static_cast<size_t>(edge_count)};
+    }
+
+    // Positions reached, ordered by depth.
+    std::span<const std::int16_t> get_positions() const {
+        return {order.data(), static_cast<size_t>(position_count)};
+    }
+
+    int get_max_depth() const {
+        return max_depth_reached;
+    }
+
+private:
+    int root = nil;
+    std::array<std::int16_t, yukon_size> depths;
+    std::array<bool, yukon_size> useful = {};
+    std::array<std::int16_t, yukon_size> order;
+    std::array<ChainEdge, BoardChains::max_edges> edges;
+    int position_count = 0;
+    int edge_count = 0;
+    int max_depth_reached = 0;
+};
@@ -0,0 +1,96 @@
+#include <array>
+
+#include "deadlock.h"
+
+using SealedColumns = std::array<bool, yukon_width>;
+
+// Whether `card` is out of reach for as long as the face-up cards of `col`
+// stay where they are. With `visible_only` a face-down card may be under any
+// column with face-down cards, so it only counts as out of reach when all of
+// them are held shut.
+static bool is_unreachable(const Field &field, Card card, int col, const SealedColumns &sealed, bool visible_only) {
+    int position = field.find(card);
+    if (position >= yukon_size) {
+        return true;
+    }
+    int card_col = column_of(position);
+    if (row_of(position) >= field.hidden_count(card_col)) {
+        return false;
+    }
+    if (!visible_only) {
+        return card_col == col || sealed[card_col];
+    }
+    for (int other = 0; other < yukon_width; other++) {
+        if (field.hidden_count(other) > 0 && other != col && !sealed[other]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool can_lower_card_leave(const Field &field, int col, const SealedColumns &sealed, bool visible_only) {
+    Card lower = field.at(col, field.hidden_count(col));
+    int pip = lower.get_pip();
+
+    if (pip == pip_king) {
+        // An empty column may open up anywhere that is not sealed.
+        for (int other = 0; other < yukon_width; other++) {
+            if (other != col && !sealed[other]) {
+                return true;
+            }
+        }
+    } else {
+        for (int suit = 0; suit < suit_count; suit++) {
+            Card target{suit * pips_per_suit + pip};
+            if (target.get_color() != lower.get_color() && !is_unreachable(field, target, col, sealed, visible_only)) {
+                return true;
+            }
+        }
+    }
+
+    int suit = static_cast<int>(lower.get_suit());
+    for (int needed = field.foundation(suit).get_pip() + 1; needed < pip; needed++) {
+        if (is_unreachable(field, Card{suit * pips_per_suit + needed - 1}, col, sealed, visible_only)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Greatest fixpoint: every column with face-down cards under face-up ones
+// starts out sealed, and a column is released once its lower card could
+// leave with only the remaining sealed columns held shut. What is left
+// sealed keeps itself shut, including columns that only block each other.
+static int first_sealed_column(const Field &field, bool visible_only) {
+    SealedColumns sealed = {};
+    for (int col = 0; col < yukon_width; col++) {
+        // With nothing face up the top hidden card simply turns over.
+        sealed[col] = field.hidden_count(col) > 0 && field.hidden_count(col) < field.height(col);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int col = 0; col < yukon_width; col++) {
+            if (sealed[col] && can_lower_card_leave(field, col, sealed, visible_only)) {
+                sealed[col] = false;
+                changed = true;
+            }
+        }
+    }
+
+    for (int col = 0; col < yukon_width; col++) {
+        if (sealed[col]) {
+            return col;
+        }
+    }
+    return nil;
+}
+
+int find_sealed_column(const Field &field) {
+    return first_sealed_column(field, false);
+}
+
+int find_visibly_sealed_column(const Field &field) {
+    return first_sealed_column(field, true);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "field.h"
+
+// Static proof that a position can no longer be won, cheap enough to run on
+// every search node.
+//
+// A column is sealed when the face-up card sitting on its face-down cards can
+// never leave: every card it could be placed on is already on a foundation or
+// lies face down under it (or under another sealed column), and a card of its
+// own suit that must reach the foundation first is buried the same way. The
+// face-down cards of a sealed column never come out, so the game is lost.
+// Columns are assumed sealed until shown otherwise, so this catches circular
+// blocking between columns as well as a card buried under its own successor.
+//
+// Returns the first sealed column, or nil if none could be proven.
+int find_sealed_column(const Field &field);
+
+inline bool is_dead(const Field &field) {
+    return find_sealed_column(field) != nil;
+}
+
+// The same proof using only what a player can see: where each face-down card
+// lies is treated as unknown, so a column found here is sealed however the
+// face-down cards are arranged. Finds fewer columns than find_sealed_column.
+int find_visibly_sealed_column(const Field &field);
+
+inline bool is_visibly_dead(const Field &field) {
+    return find_visibly_sealed_column(field) != nil;
+}
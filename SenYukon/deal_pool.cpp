@@ -0,0 +1,58 @@
+#include "deal_pool.h"
+#include "rng.h"
+
+DealPool::DealPool(int capacity, SolverLimits limits)
+    : capacity(capacity),
+      limits(limits),
+      worker(&DealPool::run, this) {
+}
+
+// The worker finishes the deal it is on before it sees `stop`, which the
+// solver's time limit keeps short.
+DealPool::~DealPool() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+std::optional<std::uint64_t> DealPool::try_pop() {
+    std::optional<std::uint64_t> deal;
+    {
+        std::lock_guard lock(mutex);
+        if (deals.empty()) {
+            return deal;
+        }
+        deal = deals.front();
+        deals.pop_front();
+    }
+    wake.notify_one();
+    return deal;
+}
+
+void DealPool::run() {
+    // 2^18 buckets is 8 MiB, enough for the short budget used here.
+    Solver solver(limits, 18);
+    Field field{empty_board};
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stop || static_cast<int>(deals.size()) < capacity; });
+            if (stop) {
+                return;
+            }
+        }
+
+        std::uint64_t deal = random_deal_number();
+        field.deal(deal);
+        if (solver.solve(field).status != SolveStatus::solved) {
+            continue;
+        }
+
+        std::lock_guard lock(mutex);
+        deals.push_back(deal);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "solver.h"
+
+// Keeps a few deal numbers that a solver has already proven winnable. A
+// background thread tops the queue up whenever it drops below `capacity`;
+// popping never waits for it.
+class DealPool {
+public:
+    explicit DealPool(int capacity = 4, SolverLimits limits = {.max_nodes = 2'000'000, .max_seconds = 1.0});
+    ~DealPool();
+
+    DealPool(const DealPool &) = delete;
+    DealPool &operator=(const DealPool &) = delete;
+
+    // A verified deal number, or nothing if the pool has run dry.
+    std::optional<std::uint64_t> try_pop();
+
+private:
+    void run();
+
+    int capacity;
+    SolverLimits limits;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::uint64_t> deals;
+    bool stop = false;
+    std::thread worker;
+};
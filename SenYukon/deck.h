@@ -1,9 +1,11 @@
 #pragma once
 
 #include <array>
-#include <random>
+#include <cstdint>
+#include <utility>
 
 #include "card.h"
+#include "rng.h"
 
 class Deck {
     std::array<Card, pips_per_suit * suit_count> internal = {};
@@ -17,7 +19,16 @@ public:
     }
 
     void shuffle() {
-        std::shuffle(internal.begin(), internal.end(), std::mt19937(std::random_device()()));
+        shuffle(random_deal_number());
+    }
+
+    // Fisher-Yates driven by FastRng, so a seed always gives the same order.
+    void shuffle(std::uint64_t seed) {
+        FastRng rng{seed};
+        for (int i = static_cast<int>(internal.size()) - 1; i > 0; i--) {
+            std::swap(internal[i], internal[rng.below(static_cast<std::uint32_t>(i + 1))]);
+        }
+        iter = 0;
     }
 
     Card next() {
@@ -60,5 +60,17 @@ constexpr int pip_king = 13;
 constexpr int card_min = 0;
 constexpr int card_max = hidden * 2 - 1;
 
+constexpr int position_of(int col, int row) {
+    return row * yukon_width + col;
+}
+
+constexpr int column_of(int position) {
+    return position % yukon_width;
+}
+
+constexpr int row_of(int position) {
+    return position / yukon_width;
+}
+
 static_assert(hidden != 0);
 static_assert(pips_per_suit != 0);
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "difficulty.h"
+#include "rng.h"
+
+const char *difficulty_name(Difficulty difficulty) {
+    switch (difficulty) {
+    case Difficulty::easy:
+        return "easy";
+    case Difficulty::medium:
+        return "medium";
+    case Difficulty::hard:
+        return "hard";
+    }
+    return "";
+}
+
+// Face-down cards covering a lower card of their own suit. Each one has to
+// be turned up and moved aside before that lower card can go home.
+static int count_blocking_hidden(const Field &field) {
+    int count = 0;
+    for (int col = 0; col < yukon_width; col++) {
+        std::array<int, suit_count> lowest;
+        lowest.fill(pip_king + 1);
+        for (int row = 0; row < field.height(col); row++) {
+            Card card = field.at(col, row);
+            int suit = static_cast<int>(card.get_suit());
+            if (row < field.hidden_count(col) && card.get_pip() > lowest[suit]) {
+                count++;
+            }
+            lowest[suit] = std::min(lowest[suit], card.get_pip());
+        }
+    }
+    return count;
+}
+
+static double clamp01(double value) {
+    return std::clamp(value, 0.0, 1.0);
+}
+
+// Weights and ranges were fitted so that random solvable deals split roughly
+// into thirds between the levels.
+static double difficulty_score(const DifficultyRating &rating, const SolverLimits &limits) {
+    double search = std::log10(static_cast<double>(rating.nodes) + 1.0) / std::log10(static_cast<double>(limits.max_nodes) + 1.0);
+    double length = (rating.solution_length - 85.0) / 30.0;
+    double blocking = rating.blocking_hidden / 10.0;
+    double choice = (8.0 - rating.branching) / 4.0;
+    return 100.0 * (0.5 * clamp01(search) + 0.2 * clamp01(length) + 0.15 * clamp01(blocking) + 0.15 * clamp01(choice));
+}
+
+static Difficulty difficulty_level(double score) {
+    if (score < 40.0) {
+        return Difficulty::easy;
+    }
+    if (score < 52.0) {
+        return Difficulty::medium;
+    }
+    return Difficulty::hard;
+}
+
+static DifficultyRating rate_with(Solver &solver, const Field &field, const SolverLimits &limits) {
+    DifficultyRating rating;
+    rating.blocking_hidden = count_blocking_hidden(field);
+
+    SolveResult result = solver.solve(field);
+    rating.status = result.status;
+    rating.nodes = result.nodes;
+    if (result.status != SolveStatus::solved) {
+        rating.score = 100.0;
+        return rating;
+    }
+
+    // Average number of legal moves along the winning line.
+    Field replay = field;
+    replay.show_available();
+    std::uint64_t choices = 0;
+    for (Move move : result.solution) {
+        MoveList moves;
+        MoveGen::generate(replay, moves);
+        choices += static_cast<std::uint64_t>(moves.size());
+        replay.make(move);
+    }
+    rating.solution_length = static_cast<int>(result.solution.size());
+    rating.branching = result.solution.empty() ? 0.0 : static_cast<double>(choices) / result.solution.size();
+
+    rating.score = difficulty_score(rating, limits);
+    rating.level = difficulty_level(rating.score);
+    return rating;
+}
+
+DifficultyRating rate_difficulty(const Field &field, SolverLimits limits) {
+    Solver solver(limits, 18);
+    return rate_with(solver, field, limits);
+}
+
+DifficultyRating rate_deal(std::uint64_t deal_number, SolverLimits limits) {
+    return rate_difficulty(Field(deal_number), limits);
+}
+
+std::optional<RatedDeal> find_deal(Difficulty level, double seconds, int threads) {
+    if (threads <= 0) {
+        threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+    // A deal that is still being solved at the deadline may overrun it by
+    // at most one solver time limit.
+    SolverLimits limits = rating_limits;
+    limits.max_seconds = std::min(limits.max_seconds, seconds);
+
+    std::atomic<bool> found = false;
+    std::mutex found_mutex;
+    std::optional<RatedDeal> result;
+
+    auto work = [&]() {
+        Solver solver(limits, 18);
+        Field field{empty_board};
+        while (!found && std::chrono::steady_clock::now() < deadline) {
+            std::uint64_t deal = random_deal_number();
+            field.deal(deal);
+            DifficultyRating rating = rate_with(solver, field, limits);
+            if (rating.status != SolveStatus::solved || rating.level != level) {
+                continue;
+            }
+
+            std::lock_guard lock(found_mutex);
+            if (!found) {
+                result = RatedDeal{deal, rating};
+                found = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(work);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return result;
+}
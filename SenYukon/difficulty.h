@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "field.h"
+#include "solver.h"
+
+enum class Difficulty {
+    easy,
+    medium,
+    hard,
+};
+
+const char *difficulty_name(Difficulty difficulty);
+
+struct DifficultyRating {
+    SolveStatus status = SolveStatus::timeout;
+    // 0 (trivial) to 100; only meaningful for solved deals.
+    double score = 0.0;
+    Difficulty level = Difficulty::hard;
+
+    // The features the score is built from.
+    std::uint64_t nodes = 0;
+    int solution_length = 0;
+    int blocking_hidden = 0;
+    double branching = 0.0;
+};
+
+struct RatedDeal {
+    std::uint64_t deal_number = 0;
+    DifficultyRating rating;
+};
+
+static constexpr SolverLimits rating_limits = {
+    .max_nodes = 1'000'000,
+    .max_seconds = 0.5,
+};
+
+// Solves `field` once and scores how hard it is to win from here. The
+// features are measured one after another on the calling thread: the solve
+// is nearly all of the work and the others need its solution, and a
+// parallel solve would make the node count depend on thread timing.
+// find_deal() gets its parallelism from rating several deals at once.
+DifficultyRating rate_difficulty(const Field &field, SolverLimits limits = rating_limits);
+DifficultyRating rate_deal(std::uint64_t deal_number, SolverLimits limits = rating_limits);
+
+// Rates random deals on `threads` threads (0 uses every core) until one of
+// the wanted level turns up or `seconds` run out.
+std::optional<RatedDeal> find_deal(Difficulty level, double seconds, int threads = 0);
@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <string>
+
+#include "deadlock.h"
+#include "external_solver.h"
+#include "miniz.h"
+
+PackedField PackedField::pack(const Field &field) {
+    std::array<int, yukon_width> order;
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&field](int a, int b) {
+        for (int row = 0; row < field.height(a) && row < field.height(b); row++) {
+            if (field.at(a, row).get_raw() != field.at(b, row).get_raw()) {
+                return field.at(a, row).get_raw() < field.at(b, row).get_raw();
+            }
+        }
+        return field.height(a) < field.height(b);
+    });
+
+    PackedField packed;
+    packed.bytes.fill(0xFF);
+    int index = 0;
+    for (int i = 0; i < yukon_width; i++) {
+        int col = order[i];
+        for (int row = 0; row < field.height(col); row++) {
+            packed.bytes[index++] = static_cast<std::uint8_t>(field.at(col, row).get_raw());
+        }
+        packed.bytes[card_bytes + i] = static_cast<std::uint8_t>(field.height(col));
+    }
+    return packed;
+}
+
+void PackedField::unpack(Field &field) const {
+    field.clear();
+
+    std::array<int, foundation_count> home;
+    home.fill(pips_per_suit);
+    int index = 0;
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < bytes[card_bytes + col]; row++) {
+            Card card{bytes[index++]};
+            field.push(col, card);
+            home[static_cast<int>(card.get_suit())]--;
+        }
+    }
+    for (int suit = 0; suit < foundation_count; suit++) {
+        field.fill_foundation(suit, home[suit] ? Card{suit * pips_per_suit + home[suit] - 1} : Card{nil});
+    }
+}
+
+int PackedField::progress() const {
+    int on_tableau = 0;
+    int face_down = 0;
+    for (int i = 0; i < card_bytes && bytes[i] != 0xFF; i++) {
+        on_tableau++;
+        face_down += bytes[i] >= hidden;
+    }
+    return (hidden - on_tableau) + (hidden - face_down);
+}
+
+namespace {
+
+constexpr int max_progress = hidden * 2;
+constexpr std::size_t block_records = 8192;
+// Keeps the number of files open during a merge well under OS limits.
+constexpr std::size_t max_merge_width = 64;
+
+// Runs are a sequence of deflated blocks, each led by its record count and
+// compressed size.
+class RunWriter {
+    std::ofstream file;
+    std::vector<PackedField> block;
+    std::vector<unsigned char> compressed;
+    std::uint64_t count = 0;
+    bool ok = true;
+
+public:
+    explicit RunWriter(const std::filesystem::path &path)
+        : file(path, std::ios::binary) {
+        ok = file.is_open();
+        block.reserve(block_records);
+    }
+
+    void write(const PackedField &record) {
+        block.push_back(record);
+        count++;
+        if (block.size() == block_records) {
+            flush_block();
+        }
+    }
+
+    bool close() {
+        flush_block();
+        file.close();
+        return ok && !file.fail();
+    }
+
+    std::uint64_t get_count() const {
+        return count;
+    }
+
+private:
+    void flush_block() {
+        if (block.empty() || !ok) {
+            block.clear();
+            return;
+        }
+        mz_ulong source_size = static_cast<mz_ulong>(block.size() * sizeof(PackedField));
+        mz_ulong compressed_size = mz_compressBound(source_size);
+        compressed.resize(compressed_size);
+        if (mz_compress2(compressed.data(), &compressed_size, reinterpret_cast<const unsigned char *>(block.data()), source_size, MZ_BEST_SPEED) != MZ_OK) {
+            ok = false;
+            return;
+        }
+
+        std::uint32_t header[2] = {static_cast<std::uint32_t>(block.size()), static_cast<std::uint32_t>(compressed_size)};
+        file.write(reinterpret_cast<const char *>(header), sizeof header);
+        file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed_size));
+        ok = ok && file.good();
+        block.clear();
+    }
+};
+
+class RunReader {
+    std::ifstream file;
+    std::vector<PackedField> block;
+    std::vector<unsigned char> compressed;
+    std::size_t index = 0;
+    bool ok = true;
+
+public:
+    explicit RunReader(const std::filesystem::path &path)
+        : file(path, std::ios::binary) {
+        ok = file.is_open();
+    }
+
+    bool next(PackedField &record) {
+        if (index == block.size() && !read_block()) {
+            return false;
+        }
+        record = block[index++];
+        return true;
+    }
+
+    bool is_ok() const {
+        return ok;
+    }
+
+private:
+    bool read_block() {
+        std::uint32_t header[2];
+        if (!ok || !file.read(reinterpret_cast<char *>(header), sizeof header)) {
+            // Running out of blocks at a block boundary is the normal end.
+            ok = ok && file.eof() && file.gcount() == 0;
+            return false;
+        }
+
+        compressed.resize(header[1]);
+        block.resize(header[0]);
+        mz_ulong size = static_cast<mz_ulong>(block.size() * sizeof(PackedField));
+        if (!file.read(reinterpret_cast<char *>(compressed.data()), header[1]) ||
+            mz_uncompress(reinterpret_cast<unsigned char *>(block.data()), &size, compressed.data(), header[1]) != MZ_OK ||
+            size != block.size() * sizeof(PackedField)) {
+            ok = false;
+            return false;
+        }
+        index = 0;
+        return !block.empty();
+    }
+};
+
+// Streams the sorted union of several sorted runs, without repeats.
+class RunMerger {
+    using Head = std::pair<PackedField, std::size_t>;
+
+    std::vector<std::unique_ptr<RunReader>> readers;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::optional<PackedField> last;
+
+public:
+    explicit RunMerger(const std::vector<std::filesystem::path> &runs) {
+        for (const auto &run : runs) {
+            readers.push_back(std::make_unique<RunReader>(run));
+            advance(readers.size() - 1);
+        }
+    }
+
+    bool next(PackedField &record) {
+        while (!heads.empty()) {
+            auto [head, reader] = heads.top();
+            heads.pop();
+            advance(reader);
+            if (last != head) {
+                last = head;
+                record = head;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool is_ok() const {
+        return std::all_of(readers.begin(), readers.end(), [](const auto &reader) { return reader->is_ok(); });
+    }
+
+private:
+    void advance(std::size_t reader) {
+        PackedField record;
+        if (readers[reader]->next(record)) {
+            heads.emplace(record, reader);
+        }
+    }
+};
+
+void remove_runs(const std::vector<std::filesystem::path> &runs) {
+    std::error_code error;
+    for (const auto &run : runs) {
+        std::filesystem::remove(run, error);
+    }
+}
+
+} // namespace
+
+// Merges runs in groups until one merge can take them all at once.
+bool ExternalSolver::narrow_runs(std::vector<Run> &runs) {
+    while (runs.size() > max_merge_width) {
+        std::vector<Run> merged;
+        for (std::size_t first = 0; first < runs.size(); first += max_merge_width) {
+            std::vector<Run> group(runs.begin() + first, runs.begin() + std::min(first + max_merge_width, runs.size()));
+            Run run = new_run();
+            RunMerger merger(group);
+            RunWriter writer(run);
+            PackedField record;
+            while (merger.next(record)) {
+                writer.write(record);
+            }
+            bool ok = writer.close() && merger.is_ok();
+            remove_runs(group);
+            merged.push_back(run);
+            if (!ok) {
+                merged.insert(merged.end(), runs.begin() + std::min(first + max_merge_width, runs.size()), runs.end());
+                runs = std::move(merged);
+                return false;
+            }
+        }
+        runs = std::move(merged);
+    }
+    return true;
+}
+
+ExternalSolver::ExternalSolver(ExternalLimits limits)
+    : limits(std::move(limits)) {
+}
+
+SolveResult ExternalSolver::solve(const Field &field) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.max_seconds));
+    nodes = 0;
+    solved = false;
+    stopped = false;
+    pending.assign(max_progress + 1, {});
+
+    std::error_code error;
+    std::filesystem::create_directories(limits.directory, error);
+
+    Field root = field;
+    root.show_available();
+    if (root.is_finished()) {
+        solved = true;
+    } else {
+        PackedField packed = PackedField::pack(root);
+        Run run = new_run();
+        RunWriter writer(run);
+        writer.write(packed);
+        stopped = !writer.close();
+        pending[packed.progress()].push_back(run);
+    }
+
+    for (int progress = 0; progress <= max_progress && !solved && !stopped; progress++) {
+        if (!pending[progress].empty()) {
+            search_level(progress);
+        }
+    }
+    for (const auto &runs : pending) {
+        remove_runs(runs);
+    }
+
+    SolveResult result;
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (solved) {
+        result.status = SolveStatus::solved;
+    } else if (stopped) {
+        result.status = SolveStatus::timeout;
+    } else {
+        result.status = SolveStatus::unsolvable;
+    }
+    return result;
+}
+
+void ExternalSolver::search_level(int progress) {
+    std::vector<Run> incoming = std::move(pending[progress]);
+    pending[progress].clear();
+    std::vector<Run> visited;
+
+    while (!incoming.empty() && !solved && !stopped) {
+        if (!narrow_runs(incoming)) {
+            stopped = true;
+            break;
+        }
+
+        // Drop everything this level has already seen, and fold the rest
+        // into the visited file in the same pass.
+        Run frontier = new_run();
+        Run next_visited = new_run();
+        std::uint64_t frontier_size = 0;
+        {
+            RunMerger candidates(incoming);
+            RunMerger seen(visited);
+            RunWriter frontier_writer(frontier);
+            RunWriter visited_writer(next_visited);
+
+            PackedField record;
+            PackedField old;
+            bool has_old = seen.next(old);
+            while (candidates.next(record)) {
+                while (has_old && old < record) {
+                    visited_writer.write(old);
+                    has_old = seen.next(old);
+                }
+                if (has_old && old == record) {
+                    continue;
+                }
+                frontier_writer.write(record);
+                visited_writer.write(record);
+            }
+            while (has_old) {
+                visited_writer.write(old);
+                has_old = seen.next(old);
+            }
+
+            frontier_size = frontier_writer.get_count();
+            bool written = frontier_writer.close() && visited_writer.close();
+            stopped = !written || !candidates.is_ok() || !seen.is_ok();
+        }
+        remove_runs(incoming);
+        remove_runs(visited);
+        incoming.clear();
+        visited = {next_visited};
+
+        if (frontier_size > 0 && !stopped) {
+            expand(frontier, progress, incoming);
+        }
+        remove_runs({frontier});
+    }
+    remove_runs(incoming);
+    remove_runs(visited);
+}
+
+void ExternalSolver::expand(const Run &frontier, int progress, std::vector<Run> &next_runs) {
+    std::size_t capacity = std::max(limits.memory_budget / sizeof(PackedField), std::size_t{max_moves} * 2);
+    std::vector<PackedField> buffer;
+    buffer.reserve(capacity);
+
+    Field field{empty_board};
+    RunReader reader(frontier);
+    PackedField record;
+    while (reader.next(record)) {
+        nodes++;
+        if (out_of_budget()) {
+            stopped = true;
+            return;
+        }
+
+        record.unpack(field);
+        MoveList moves;
+        generate_search_moves(field, moves);
+        for (Move move : moves) {
+            Undo undo = field.make(move);
+            if (field.is_finished()) {
+                solved = true;
+                return;
+            }
+            if (!is_dead(field)) {
+                buffer.push_back(PackedField::pack(field));
+            }
+            field.unmake(undo);
+        }
+
+        if (buffer.size() + max_moves > capacity && !flush(buffer, progress, next_runs)) {
+            stopped = true;
+            return;
+        }
+    }
+    if (!reader.is_ok() || !flush(buffer, progress, next_runs)) {
+        stopped = true;
+    }
+}
+
+// Sorts the buffered successors and writes them out as one run per progress
+// level they belong to.
+bool ExternalSolver::flush(std::vector<PackedField> &buffer, int progress, std::vector<Run> &next_runs) {
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+    std::map<int, RunWriter> writers;
+    for (const PackedField &record : buffer) {
+        int level = record.progress();
+        assert(level >= progress);
+        auto writer = writers.find(level);
+        if (writer == writers.end()) {
+            Run run = new_run();
+            (level == progress ? next_runs : pending[level]).push_back(run);
+            writer = writers.try_emplace(level, run).first;
+        }
+        writer->second.write(record);
+    }
+    buffer.clear();
+
+    bool ok = true;
+    for (auto &[level, writer] : writers) {
+        ok = writer.close() && ok;
+    }
+    return ok;
+}
+
+ExternalSolver::Run ExternalSolver::new_run() {
+    return limits.directory / ("run-" + std::to_string(next_run_id++) + ".bin");
+}
+
+bool ExternalSolver::out_of_budget() {
+    if (nodes >= limits.max_nodes) {
+        return true;
+    }
+    return (nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline;
+}
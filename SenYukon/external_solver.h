@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "field.h"
+#include "solver.h"
+
+// Fixed-size record of a full-information position for the spill files.
+// Cards are listed column after column with face-down cards keeping their
+// hidden raw value, followed by the column heights. Columns are written in
+// sorted order, so positions that only differ by column order pack the same.
+// Whatever is missing from the tableau sits on the foundations.
+struct PackedField {
+    static constexpr int card_bytes = yukon_height;
+    static constexpr int size = card_bytes + yukon_width;
+
+    std::array<std::uint8_t, size> bytes;
+
+    static PackedField pack(const Field &field);
+    void unpack(Field &field) const;
+
+    // Cards on the foundations plus cards face up or home. No move lowers
+    // it, so a position can only repeat among records of equal progress.
+    int progress() const;
+
+    auto operator<=>(const PackedField &) const = default;
+};
+
+struct ExternalLimits {
+    std::uint64_t max_nodes = UINT64_MAX;
+    double max_seconds = 12.0 * 60 * 60;
+    // Caps the successor buffer; sorted runs beyond it go to disk.
+    std::size_t memory_budget = std::size_t{1} << 30;
+    std::filesystem::path directory = "yukon_spill";
+};
+
+// Breadth-first reachability search that keeps its state on disk, for deals
+// whose search would not fit a transposition table in RAM. Positions are
+// processed in order of progress; within one progress level the search goes
+// layer by layer with delayed duplicate detection: successors are gathered
+// in memory, sorted and written out as compressed runs, then merged and
+// checked against the level's visited file in one streaming pass. A level
+// is deleted once done, since no move leads back into it.
+//
+// A solved result only settles that a solution exists; no move list is
+// kept. Failing to read or write the spill files ends the search as a
+// timeout.
+class ExternalSolver {
+public:
+    explicit ExternalSolver(ExternalLimits limits = {});
+    SolveResult solve(const Field &field);
+
+private:
+    using Run = std::filesystem::path;
+
+    void search_level(int progress);
+    void expand(const Run &frontier, int progress, std::vector<Run> &next_runs);
+    bool flush(std::vector<PackedField> &buffer, int progress, std::vector<Run> &next_runs);
+    bool narrow_runs(std::vector<Run> &runs);
+    Run new_run();
+    bool out_of_budget();
+
+    ExternalLimits limits;
+    std::vector<std::vector<Run>> pending;
+    std::uint64_t next_run_id = 0;
+    std::uint64_t nodes = 0;
+    bool solved = false;
+    bool stopped = false;
+    std::chrono::steady_clock::time_point deadline;
+};
@@ -1,24 +1,93 @@
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <fstream>
+#include <memory>
 
-#include "raylib.h"
-#include "animation.h"
-
+#include "canonical.h"
 #include "deck.h"
 #include "field.h"
-#include "sound_manager.h"
+#include "rng.h"
+
+namespace {
+
+// Keys for the Zobrist hash. Cards are keyed by identity and slot; whether they
+// are face down follows from the hidden count, which has keys of its own. The
+// keys for an empty foundation and for zero hidden cards are zero, so an empty
+// field hashes to zero.
+struct ZobristKeys {
+    std::array<std::array<std::array<std::uint64_t, hidden>, yukon_height>, yukon_width> cells;
+    std::array<std::array<std::uint64_t, yukon_height + 1>, yukon_width> hidden_counts;
+    std::array<std::array<std::uint64_t, pips_per_suit + 1>, foundation_count> foundations;
+};
+
+ZobristKeys make_zobrist_keys() {
+    auto keys = std::make_unique<ZobristKeys>();
+    FastRng rng{0x5E9'1C0A'7B3D'2F41};
+
+    for (auto &col : keys->cells) {
+        for (auto &row : col) {
+            for (auto &key : row) {
+                key = rng.next();
+            }
+        }
+    }
+    for (auto &col : keys->hidden_counts) {
+        for (auto &key : col) {
+            key = rng.next();
+        }
+        col[0] = 0;
+    }
+    for (auto &suit : keys->foundations) {
+        for (auto &key : suit) {
+            key = rng.next();
+        }
+        suit[0] = 0;
+    }
+    return *keys;
+}
+
+const ZobristKeys zobrist = make_zobrist_keys();
 
-Field::Field() {
+} // namespace
+
+Field::Field()
+    : Field(random_deal_number()) {
+}
+
+// Same as after clear(): every member starts out empty.
+Field::Field(EmptyBoard) {
+}
+
+Field::Field(std::uint64_t deal_number) {
+    deal(deal_number);
+}
+
+// Lays out deal number `deal_number`: the same number always gives the same
+// board.
+void Field::deal(std::uint64_t deal_number) {
     Deck source = {};
+    source.shuffle(deal_number);
+    deal(source);
+}
 
-    source.shuffle();
+// Lays out `source` from its current position on, the way a fresh shuffle
+// is dealt.
+void Field::deal(Deck source) {
+    clear();
 
+    // Cards are placed directly and each column is settled once at the end,
+    // which keeps bulk dealing cheap.
+    auto place = [this](int col, Card card) {
+        put(col, height(col), card);
+        heights[col]++;
+    };
     for (int y = 0; y < raw_size; y++) {
         for (int x = y; x < raw_size; x++) {
             if (x == y) {
-                push(x, source.next().show());
+                place(x, source.next().show());
             } else {
-                push(x, source.next().hide());
+                place(x, source.next().hide());
             }
         }
     }
@@ -31,69 +100,156 @@ Field::Field() {
         if (obtained.is_nil()) {
             break;
         }
-        push(x, obtained.show());
+        place(x, obtained.show());
+    }
+
+    for (int col = 0; col < yukon_width; col++) {
+        settle_column(col, 0);
     }
 }
 
 void Field::push(int col, Card card) {
     assert(col >= 0 && col < raw_size);
-    for (int i = 0; i < yukon_height; i++) {
-        if ((*this)[i * raw_size + col].is_nil()) {
-            (*this)[i * raw_size + col] = card;
-            return;
-        }
-    }
+    assert(height(col) < yukon_height);
+
+    int row = height(col);
+    put(col, row, card);
+    heights[col]++;
+    settle_column(col, row);
 }
 
 bool Field::is_front(int position) const {
-    if (position >= yukon_size - raw_size && position < yukon_size) {
-        return true;
-    }
-    if (position >= 0 && position < yukon_size - raw_size) {
-        return (*this)[position + raw_size].is_nil();
+    if (position < 0 || position >= yukon_size) {
+        return false;
     }
-    return false;
+    return row_of(position) + 1 >= height(column_of(position));
 }
 
 int Field::get_front(int col) const {
     assert(col >= 0 && col < raw_size);
-    for (int i = col; i < yukon_size; i += raw_size) {
-        if (is_front(i)) {
-            return i;
-        }
+    int h = height(col);
+    return position_of(col, h ? h - 1 : 0);
+}
+
+void Field::swap(int a, int b) {
+    int col_a = column_of(a);
+    int row_a = row_of(a);
+    int col_b = column_of(b);
+    int row_b = row_of(b);
+
+    assert(a >= 0 && a < yukon_size && b >= 0 && b < yukon_size);
+    assert(col_a != col_b);
+    assert(row_a <= height(col_a) && row_b <= height(col_b));
+
+    int count_a = height(col_a) - row_a;
+    int count_b = height(col_b) - row_b;
+    if (count_b == 0) {
+        move_stack(col_a, row_a, col_b);
+        return;
+    }
+    if (count_a == 0) {
+        move_stack(col_b, row_b, col_a);
+        return;
+    }
+
+    std::array<Card, yukon_height> lifted;
+    for (int i = 0; i < count_a; i++) {
+        lifted[i] = take(col_a, row_a + i);
+    }
+    for (int i = 0; i < count_b; i++) {
+        put(col_a, row_a + i, take(col_b, row_b + i));
+    }
+    for (int i = 0; i < count_a; i++) {
+        put(col_b, row_b + i, lifted[i]);
     }
 
-    return nil;
+    heights[col_a] = static_cast<std::uint8_t>(row_a + count_b);
+    heights[col_b] = static_cast<std::uint8_t>(row_b + count_a);
+    settle_column(col_a, row_a);
+    settle_column(col_b, row_b);
 }
 
-void Field::swap(int a, int b) {
-    for (; a >= 0 && b >= 0 && a < yukon_size && b < yukon_size; a += raw_size, b += raw_size) {
-        if ((*this)[a].is_nil() && (*this)[b].is_nil()) {
-            break;
-        }
+// Exchanges two face-down cards. Hidden cards never take part in a tie, so
+// only the cells themselves change.
+void Field::swap_hidden(int col_a, int row_a, int col_b, int row_b) {
+    assert(row_a < hidden_count(col_a) && row_b < hidden_count(col_b));
+    if (col_a == col_b && row_a == row_b) {
+        return;
+    }
+
+    Card card_a = take(col_a, row_a);
+    Card card_b = take(col_b, row_b);
+    put(col_a, row_a, card_b);
+    put(col_b, row_b, card_a);
+}
 
-        std::swap((*this)[a], (*this)[b]);
+void Field::move_stack(int from_col, int from_row, int to_col) {
+    assert(from_col != to_col);
+    assert(from_row >= 0 && from_row <= height(from_col));
+
+    int count = height(from_col) - from_row;
+    int to_row = height(to_col);
+    assert(to_row + count <= yukon_height);
+
+    for (int i = 0; i < count; i++) {
+        put(to_col, to_row + i, take(from_col, from_row + i));
+    }
+
+    heights[from_col] = static_cast<std::uint8_t>(from_row);
+    heights[to_col] = static_cast<std::uint8_t>(to_row + count);
+    settle_column(from_col, from_row);
+    settle_column(to_col, to_row);
+}
+
+bool Field::reveal(int col) {
+    int h = height(col);
+    if (h == 0 || hidden_count(col) != h) {
+        return false;
     }
+    columns[col][h - 1] = columns[col][h - 1].show();
+    settle_column(col, h - 1);
+    return true;
 }
 
 void Field::show_available() {
-    int i;
-    for (i = 0; i < yukon_size - raw_size; i++) {
-        if ((*this)[i].is_nil()) {
-            continue;
-        }
-        if (!((*this)[i]).is_hidden()) {
-            continue;
-        }
-        if (!(*this)[i + raw_size].is_nil()) {
-            continue;
-        }
-        (*this)[i] = (*this)[i].show();
+    for (int col = 0; col < raw_size; col++) {
+        reveal(col);
     }
-    for (; i < yukon_size; i++) {
-        if (!(*this)[i].is_nil()) {
-            (*this)[i] = (*this)[i].show();
-        }
+}
+
+// Applies a legal move and turns over the card it uncovers, if any.
+Undo Field::make(Move move) {
+    Undo undo;
+    undo.move = move;
+    undo.card = at(move.from_col, move.from_row);
+
+    if (move.kind == MoveKind::foundation) {
+        undo.count = 1;
+        feed_foundation(position_of(move.from_col, move.from_row));
+    } else {
+        undo.count = static_cast<std::uint8_t>(height(move.from_col) - move.from_row);
+        undo.to_row = static_cast<std::uint8_t>(height(move.to_col));
+        move_stack(move.from_col, move.from_row, move.to_col);
+    }
+    undo.revealed = reveal(move.from_col);
+
+    return undo;
+}
+
+void Field::unmake(const Undo &undo) {
+    const Move &move = undo.move;
+
+    if (undo.revealed) {
+        conceal(move.from_col);
+    }
+
+    if (move.kind == MoveKind::foundation) {
+        int suit = static_cast<int>(undo.card.get_suit());
+        int pip = undo.card.get_pip();
+        set_foundation(suit, pip == pip_ace ? Card{nil} : Card{suit * pips_per_suit + pip - 2});
+        push(move.from_col, undo.card);
+    } else {
+        move_stack(move.to_col, undo.to_row, move.from_col);
     }
 }
 
@@ -118,84 +274,187 @@ bool Field::can_feed_foundation(int position) const {
 }
 
 void Field::feed_foundation(int position) {
-    (*this)[yukon_size + static_cast<int>((*this)[position].get_suit())] = (*this)[position];
-    (*this)[position] = Card{nil};
-}
-
-void Field::render() {
-    for (int x = 0; x < yukon_width; x++) {
-        for (int y = 0; y < yukon_height - 1; y++) {
-            Card upper = (*this)[x + y * raw_size];
-            Card lower = (*this)[x + (y+1) * raw_size];
-            
-            bool is_tied = true;
-            is_tied = is_tied && !upper.is_nil();
-            is_tied = is_tied && !lower.is_nil();
-            is_tied = is_tied && !upper.is_hidden();
-            is_tied = is_tied && !lower.is_hidden();
-            is_tied = is_tied && (upper.get_color() != lower.get_color());
-            is_tied = is_tied && (upper.get_pip() - 1 == lower.get_pip());
-            is_tied = is_tied && (upper.get_pip() != 1);
-
-            if (is_tied) {
-                DrawRectangle(x * cell_width - 4, y * cell_height + cell_height + 10, 4, cell_height * 2 - 20, YELLOW);
-            }
-        }
-    }
+    assert(is_front(position));
 
-    for (int y = 0; y < yukon_height; y++) {
-        for (int x = 0; x < yukon_width; x++) {
-            Card target = (*this)[x + y * raw_size];
-            std::string string = target.to_string();
-            Color color;
-            
-            if (string == "HID") {
-                color = LIGHTGRAY;
-            } else if (target.get_color() == SuitColor::red) {
-                color = RED;
-            } else {
-                color = WHITE;
-            }
-            if (can_feed_foundation(x + y * raw_size)) {
-                color = Fade(color, sin(GetTime() * 5.0) + 1.0);
-                DrawText(string.c_str(), x * cell_width, cell_height + y * cell_height, cell_height, color);
-            } else {
-                DrawText(string.c_str(), x * cell_width, cell_height + y * cell_height, cell_height, color);
-            }
-        }
+    int col = column_of(position);
+    int row = row_of(position);
+    Card card = take(col, row);
+
+    set_foundation(static_cast<int>(card.get_suit()), card);
+    heights[col] = static_cast<std::uint8_t>(row);
+    settle_column(col, row);
+}
+
+// Grid position of `card`, or nil if it has not been dealt. Cards on a
+// foundation report that foundation's slot.
+int Field::find(Card card) const {
+    assert(!card.is_nil());
+    return card_positions[card.show().get_raw()];
+}
+
+// Positions of the two cards with the given pip and colour.
+std::array<int, 2> Field::find(int pip, SuitColor color) const {
+    if (pip < pip_ace || pip > pip_king) {
+        return {nil, nil};
     }
+    int pip_index = pip - 1;
+    if (color == SuitColor::red) {
+        return {
+            card_positions[static_cast<int>(Suit::heart) * pips_per_suit + pip_index],
+            card_positions[static_cast<int>(Suit::diamond) * pips_per_suit + pip_index],
+        };
+    }
+    return {
+        card_positions[static_cast<int>(Suit::spade) * pips_per_suit + pip_index],
+        card_positions[static_cast<int>(Suit::club) * pips_per_suit + pip_index],
+    };
+}
 
-    for (int x = 0; x < foundation_count; x++) {
-        DrawText((*this)[yukon_size + x].to_string().c_str(), x * cell_width, 0, cell_height, SKYBLUE);
+bool Field::is_face_up(int position) const {
+    if (position < 0 || position >= yukon_size) {
+        return false;
     }
+    int col = column_of(position);
+    int row = row_of(position);
+    return row >= hidden_count(col) && row < height(col);
+}
 
-    if (is_finished()) {
-        DrawText("Congratulations :)", 0, -cell_height, cell_height, WHITE);
+void Field::put(int col, int row, Card card) {
+    assert(columns[col][row].is_nil());
+    columns[col][row] = card;
+    card_positions[card.show().get_raw()] = static_cast<std::int16_t>(position_of(col, row));
+    hash ^= zobrist.cells[col][row][card.show().get_raw()];
+    toggle_column_hashes(col, canonical_cell_keys(row, card));
+}
+
+Card Field::take(int col, int row) {
+    Card card = columns[col][row];
+    assert(!card.is_nil());
+    columns[col][row] = Card{nil};
+    card_positions[card.show().get_raw()] = nil;
+    hash ^= zobrist.cells[col][row][card.show().get_raw()];
+    toggle_column_hashes(col, canonical_cell_keys(row, card));
+    return card;
+}
+
+void Field::toggle_column_hashes(int col, const SuitMapHashes &keys) {
+    for (int map = 0; map < suit_map_count; map++) {
+        column_hashes[col][map] ^= keys[map];
     }
 }
 
-bool Field::is_finished() const {
-    if ((*this)[yukon_size].get_pip() != pip_king) {
+void Field::set_hidden_count(int col, int count) {
+    hash ^= zobrist.hidden_counts[col][hidden_counts[col]];
+    hash ^= zobrist.hidden_counts[col][count];
+    toggle_column_hashes(col, canonical_hidden_keys(hidden_counts[col]));
+    toggle_column_hashes(col, canonical_hidden_keys(count));
+    hidden_counts[col] = static_cast<std::uint8_t>(count);
+}
+
+static bool continues_run(Card below, Card above) {
+    if (below.is_hidden() || above.is_hidden()) {
         return false;
     }
-    if ((*this)[yukon_size + 1].get_pip() != pip_king) {
+    if (below.get_color() == above.get_color()) {
         return false;
     }
-    if ((*this)[yukon_size + 2].get_pip() != pip_king) {
-        return false;
+    return below.get_pip() == above.get_pip() + 1;
+}
+
+// Brings the hidden count and tie bits of `col` back in step after the cards
+// from `row` upwards were replaced.
+void Field::settle_column(int col, int row) {
+    int count = std::min(hidden_count(col), row);
+    while (count < height(col) && at(col, count).is_hidden()) {
+        count++;
     }
-    if ((*this)[yukon_size + 3].get_pip() != pip_king) {
-        return false;
+    set_hidden_count(col, count);
+
+    int first = std::max(row - 1, 0);
+    std::uint64_t bits = ties[col] & ((std::uint64_t{1} << first) - 1);
+    for (int r = std::max(first, count); r + 1 < height(col); r++) {
+        if (continues_run(at(col, r), at(col, r + 1))) {
+            bits |= std::uint64_t{1} << r;
+        }
+    }
+    ties[col] = bits;
+}
+
+void Field::set_foundation(int suit, Card card) {
+    hash ^= zobrist.foundations[suit][foundations[suit].get_pip()];
+    hash ^= zobrist.foundations[suit][card.get_pip()];
+    foundations[suit] = card;
+    if (!card.is_nil()) {
+        card_positions[card.show().get_raw()] = static_cast<std::int16_t>(yukon_size + suit);
+    }
+}
+
+// Turns the top card of `col` face down again; only used to undo a reveal.
+void Field::conceal(int col) {
+    int h = height(col);
+    assert(h > 0 && hidden_count(col) == h - 1);
+    columns[col][h - 1] = columns[col][h - 1].hide();
+    settle_column(col, h - 1);
+}
+
+bool Field::is_finished() const {
+    for (Card card : foundations) {
+        if (card.get_pip() != pip_king) {
+            return false;
+        }
     }
     return true;
 }
 
-void Field::load_from_file(const std::string &filename) {
+// Save files keep the old row-major layout of 32-bit cards so existing saves still load.
+using SaveGrid = std::array<std::int32_t, yukon_size + foundation_count>;
+
+bool Field::load_from_file(const std::string &filename) {
+    SaveGrid grid;
     std::ifstream file(filename, std::ios::binary);
-    file.read(reinterpret_cast<char *>(this), sizeof *this);
+    if (!file.read(reinterpret_cast<char *>(grid.data()), sizeof grid)) {
+        return false;
+    }
+
+    clear();
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < yukon_height; row++) {
+            Card card{grid[position_of(col, row)]};
+            if (card.is_nil()) {
+                break;
+            }
+            push(col, card);
+        }
+    }
+    for (int suit = 0; suit < foundation_count; suit++) {
+        fill_foundation(suit, Card{grid[yukon_size + suit]});
+    }
+    return true;
+}
+
+void Field::clear() {
+    columns = {};
+    foundations = {};
+    heights = {};
+    hidden_counts = {};
+    ties = {};
+    card_positions = make_nil_positions();
+    hash = 0;
+    column_hashes = {};
+}
+
+// Stacks the foundation of `suit` from the ace up to `top`; nil leaves it empty.
+void Field::fill_foundation(int suit, Card top) {
+    for (int pip = foundation(suit).get_pip() + 1; pip <= top.get_pip(); pip++) {
+        set_foundation(suit, Card{suit * pips_per_suit + pip - 1});
+    }
 }
 
 void Field::save_to_file(const std::string &filename) const {
+    SaveGrid grid;
+    for (int i = 0; i < static_cast<int>(grid.size()); i++) {
+        grid[i] = (*this)[i].get_raw();
+    }
     std::ofstream file(filename, std::ios::binary);
-    file.write(reinterpret_cast<const char *>(this), sizeof *this);
+    file.write(reinterpret_cast<const char *>(grid.data()), sizeof grid);
 }
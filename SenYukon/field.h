@@ -1,49 +1,140 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <string>
 
+#include "canonical.h"
 #include "card.h"
+#include "move.h"
 
 class Animation;
- 
+class Deck;
+
+// Tag for a Field with nothing dealt, for storage that is filled in before
+// it is read; a default Field deals a whole random board.
+struct EmptyBoard {};
+inline constexpr EmptyBoard empty_board = {};
+
+// The tableau is kept as one stack per column. Cards below `hidden_counts[col]`
+// are face down, everything from there up to `heights[col]` is face up, and the
+// slots above the height are always nil so the grid view below stays valid.
 class Field {
-    std::array<Card, yukon_size + foundation_count> internal = {};
+    std::array<std::array<Card, yukon_height>, yukon_width> columns = {};
+    std::array<Card, foundation_count> foundations = {};
+    std::array<std::uint8_t, yukon_width> heights = {};
+    std::array<std::uint8_t, yukon_width> hidden_counts = {};
+    // Bit `row` is set when the card at `row + 1` sits on the card at `row` in
+    // alternating colour and descending pip.
+    std::array<std::uint64_t, yukon_width> ties = {};
+    std::array<std::int16_t, hidden> card_positions = make_nil_positions();
+    std::uint64_t hash = 0;
+    // Per-column hashes for canonical_hash, one per suit map.
+    std::array<SuitMapHashes, yukon_width> column_hashes = {};
+
+    static constexpr std::array<std::int16_t, hidden> make_nil_positions() {
+        std::array<std::int16_t, hidden> positions = {};
+        positions.fill(nil);
+        return positions;
+    }
 
 public:
     Field();
+    explicit Field(EmptyBoard);
+    explicit Field(std::uint64_t deal_number);
+    void deal(std::uint64_t deal_number);
+    void deal(Deck source);
     void push(int col, Card card);
     bool is_front(int position) const;
     int get_front(int col) const;
     void swap(int a, int b);
+    void swap_hidden(int col_a, int row_a, int col_b, int row_b);
+    void move_stack(int from_col, int from_row, int to_col);
+    bool reveal(int col);
     void show_available();
+    Undo make(Move move);
+    void unmake(const Undo &undo);
     bool can_feed_foundation(int position) const;
     void feed_foundation(int position);
+    int find(Card card) const;
+    std::array<int, 2> find(int pip, SuitColor color) const;
+    bool is_face_up(int position) const;
     void render();
     bool is_finished() const;
-    void load_from_file(const std::string &filename);
+    void clear();
+    void fill_foundation(int suit, Card top);
+    // Leaves the field untouched and returns false if the file is missing or short.
+    bool load_from_file(const std::string &filename);
     void save_to_file(const std::string &filename) const;
 
-    size_t size() const {
-        return internal.size();
+    int height(int col) const {
+        return heights[static_cast<size_t>(col)];
+    }
+
+    int hidden_count(int col) const {
+        return hidden_counts[static_cast<size_t>(col)];
+    }
+
+    Card at(int col, int row) const {
+        return columns[static_cast<size_t>(col)][static_cast<size_t>(row)];
+    }
+
+    bool is_tied(int col, int row) const {
+        return (ties[static_cast<size_t>(col)] >> row) & 1;
     }
 
-    Card &operator[](int index) {
-        return internal[static_cast<size_t>(index)];
+    Card top(int col) const {
+        int h = height(col);
+        return h ? at(col, h - 1) : Card{nil};
     }
 
+    // Zobrist hash of the position, maintained on every mutation.
+    std::uint64_t get_hash() const {
+        return hash;
+    }
+
+    const SuitMapHashes &get_column_hashes(int col) const {
+        return column_hashes[static_cast<size_t>(col)];
+    }
+
+    Card foundation(int suit) const {
+        return foundations[static_cast<size_t>(suit)];
+    }
+
+    size_t size() const {
+        return yukon_size + foundation_count;
+    }
+
+    // Read-only grid view kept for code that still thinks in row-major positions.
     Card operator[](int index) const {
-        return internal[static_cast<size_t>(index)];
+        if (index >= yukon_size) {
+            return foundation(index - yukon_size);
+        }
+        return at(column_of(index), row_of(index));
     }
 
+    // Compares hashes rather than cards; a 64-bit Zobrist collision between
+    // two positions with identical heights and foundations is not a concern.
     bool operator==(const Field &field) const {
-        return memcmp(internal.data(), field.internal.data(), sizeof internal) == 0;
+        return hash == field.hash &&
+               heights == field.heights &&
+               foundations == field.foundations;
     }
 
     bool operator!=(const Field &field) const {
         return !((*this) == field);
     }
 
-    Card* debug_get_raw() {
-        return internal.data();
+    const Card *debug_get_raw() const {
+        return columns[0].data();
     }
+
+private:
+    void put(int col, int row, Card card);
+    Card take(int col, int row);
+    void toggle_column_hashes(int col, const SuitMapHashes &keys);
+    void set_hidden_count(int col, int count);
+    void settle_column(int col, int row);
+    void set_foundation(int suit, Card card);
+    void conceal(int col);
 };
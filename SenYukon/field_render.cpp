@@ -0,0 +1,47 @@
+#include <bit>
+#include <cmath>
+
+#include "raylib.h"
+
+#include "field.h"
+
+// Kept apart from field.cpp so the solvers and tools can use Field without
+// linking raylib.
+void Field::render() {
+    for (int x = 0; x < yukon_width; x++) {
+        for (std::uint64_t bits = ties[x]; bits; bits &= bits - 1) {
+            int y = std::countr_zero(bits);
+            DrawRectangle(x * cell_width - 4, y * cell_height + cell_height + 10, 4, cell_height * 2 - 20, YELLOW);
+        }
+    }
+
+    for (int x = 0; x < yukon_width; x++) {
+        for (int y = 0; y < height(x); y++) {
+            Card target = at(x, y);
+            const char *label = target.get_label();
+            Color color;
+            
+            if (target.is_hidden()) {
+                color = LIGHTGRAY;
+            } else if (target.get_color() == SuitColor::red) {
+                color = RED;
+            } else {
+                color = WHITE;
+            }
+            if (can_feed_foundation(x + y * raw_size)) {
+                color = Fade(color, sin(GetTime() * 5.0) + 1.0);
+                DrawText(label, x * cell_width, cell_height + y * cell_height, cell_height, color);
+            } else {
+                DrawText(label, x * cell_width, cell_height + y * cell_height, cell_height, color);
+            }
+        }
+    }
+
+    for (int x = 0; x < foundation_count; x++) {
+        DrawText(foundation(x).get_label(), x * cell_width, 0, cell_height, SKYBLUE);
+    }
+
+    if (is_finished()) {
+        DrawText("Congratulations :)", 0, -cell_height, cell_height, WHITE);
+    }
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "hint_engine.h"
+#include "movegen.h"
+#include "solver.h"
+
+void determinize(Field &field, const BeliefState &belief, FastRng &rng) {
+    std::array<std::array<std::uint8_t, 2>, yukon_size> slots;
+    int count = 0;
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < field.hidden_count(col); row++) {
+            if (!belief.seen_card(col, row).is_nil()) {
+                continue;
+            }
+            slots[count++] = {static_cast<std::uint8_t>(col), static_cast<std::uint8_t>(row)};
+        }
+    }
+
+    for (int i = count - 1; i > 0; i--) {
+        int j = static_cast<int>(rng.below(static_cast<std::uint32_t>(i + 1)));
+        field.swap_hidden(slots[i][0], slots[i][1], slots[j][0], slots[j][1]);
+    }
+}
+
+HintEngine::HintEngine(HintLimits limits)
+    : limits(limits) {
+    if (this->limits.threads <= 0) {
+        this->limits.threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    this->limits.threads = std::max(this->limits.threads, 1);
+}
+
+HintResult HintEngine::suggest(const Field &field) {
+    return suggest(field, BeliefState(field));
+}
+
+HintResult HintEngine::suggest(const Field &field, const BeliefState &belief) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.max_seconds));
+
+    Field root = field;
+    root.show_available();
+
+    HintResult result;
+    result.threads = limits.threads;
+    if (root.is_finished()) {
+        result.win_probability = 1.0;
+        return result;
+    }
+
+    MoveList moves;
+    MoveGen::generate(root, moves);
+    for (Move move : moves) {
+        result.moves.push_back(MoveEstimate{.move = move});
+    }
+    if (result.moves.empty()) {
+        return result;
+    }
+
+    std::mutex mutex;
+    std::uint64_t seed = random_deal_number();
+    auto run = [&](int index) {
+        FastRng rng{seed + static_cast<std::uint64_t>(index)};
+        // The node budget keeps a single sample from overrunning the deadline by much.
+        Solver solver(SolverLimits{.max_nodes = limits.max_nodes_per_sample, .max_seconds = limits.max_seconds, .weights = limits.weights}, 16);
+        std::vector<MoveEstimate> local(result.moves.size());
+
+        // One layout per round, shared by every move so they are compared on
+        // the same cards. The starting move rotates so a round cut short by
+        // the deadline does not always shortchange the same moves.
+        bool out_of_time = false;
+        for (size_t round = 0; !out_of_time; round++) {
+            Field sample = root;
+            determinize(sample, belief, rng);
+            for (size_t k = 0; k < local.size(); k++) {
+                size_t i = (round + k) % local.size();
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    out_of_time = true;
+                    break;
+                }
+
+                Field child = sample;
+                child.make(result.moves[i].move);
+                SolveResult solved = solver.solve(child);
+                local[i].samples++;
+                if (solved.status == SolveStatus::solved) {
+                    local[i].wins++;
+                } else if (solved.status == SolveStatus::timeout) {
+                    local[i].undecided++;
+                }
+            }
+        }
+
+        std::lock_guard lock(mutex);
+        for (size_t i = 0; i < local.size(); i++) {
+            result.moves[i].samples += local[i].samples;
+            result.moves[i].wins += local[i].wins;
+            result.moves[i].undecided += local[i].undecided;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < limits.threads; i++) {
+        threads.emplace_back(run, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto best = std::max_element(result.moves.begin(), result.moves.end(), [](const MoveEstimate &a, const MoveEstimate &b) {
+        return a.win_rate() < b.win_rate();
+    });
+    result.has_move = true;
+    result.move = best->move;
+    result.win_probability = best->win_rate();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
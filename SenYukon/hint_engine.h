@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "belief_state.h"
+#include "field.h"
+#include "move.h"
+#include "rng.h"
+#include "search_weights.h"
+
+struct HintLimits {
+    double max_seconds = 1.0;
+    // <= 0 uses every hardware thread.
+    int threads = 0;
+    // Budget for judging one move on one sampled layout.
+    std::uint64_t max_nodes_per_sample = 20'000;
+    SearchWeights weights;
+};
+
+struct MoveEstimate {
+    Move move;
+    int samples = 0;
+    int wins = 0;
+    // Samples the solver could not decide within its budget; they count as
+    // half a win.
+    int undecided = 0;
+
+    double win_rate() const {
+        return samples ? (wins + 0.5 * undecided) / samples : 0.0;
+    }
+};
+
+struct HintResult {
+    bool has_move = false;
+    Move move;
+    double win_probability = 0.0;
+    std::vector<MoveEstimate> moves;
+    double seconds = 0.0;
+    int threads = 1;
+};
+
+// Shuffles the face-down cards among the face-down slots the player has not
+// seen. Every layout consistent with `belief` is equally likely.
+void determinize(Field &field, const BeliefState &belief, FastRng &rng);
+
+// Hints that only use what the player can see. Each round samples a layout
+// of the hidden cards, plays every legal move on it and asks the solver
+// whether the result is winnable; the move that wins on the most layouts is
+// suggested. Rounds run on every thread until the time is up.
+//
+// The solver sees the sampled layout, so each sample is an optimistic
+// judgement and the win probability is an upper estimate.
+class HintEngine {
+public:
+    explicit HintEngine(HintLimits limits = {});
+    HintResult suggest(const Field &field);
+    HintResult suggest(const Field &field, const BeliefState &belief);
+
+private:
+    HintLimits limits;
+};
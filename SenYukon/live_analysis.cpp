@@ -0,0 +1,186 @@
+#include <algorithm>
+
+#include "deadlock.h"
+#include "live_analysis.h"
+#include "solver.h"
+
+static constexpr int max_live_depth = 400;
+
+LiveAnalysis::LiveAnalysis(std::uint64_t max_nodes, int proven_log2_entries)
+    : max_nodes(max_nodes),
+      proven(size_t{1} << proven_log2_entries),
+      proven_mask((std::uint64_t{1} << proven_log2_entries) - 1),
+      worker(&LiveAnalysis::run, this) {
+}
+
+LiveAnalysis::~LiveAnalysis() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+        generation++;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void LiveAnalysis::set_position(const Field &field) {
+    {
+        std::lock_guard lock(mutex);
+        target = field;
+        report = LiveReport{.hash = field.get_hash()};
+        generation++;
+    }
+    wake.notify_one();
+}
+
+LiveReport LiveAnalysis::get_report() {
+    std::lock_guard lock(mutex);
+    return report;
+}
+
+void LiveAnalysis::publish(const LiveReport &result) {
+    std::lock_guard lock(mutex);
+    // A result for a position the UI has since left is of no use.
+    if (generation == search_generation) {
+        report = result;
+    }
+}
+
+void LiveAnalysis::run() {
+    std::uint64_t handled = 0;
+    Field field{empty_board};
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stop || generation != handled; });
+            if (stop) {
+                return;
+            }
+            handled = generation;
+            field = target;
+        }
+
+        search_generation = handled;
+        publish(analyse(field));
+    }
+}
+
+const LiveAnalysis::Proven *LiveAnalysis::find_proven(std::uint64_t key) const {
+    const Proven &entry = proven[key & proven_mask];
+    return entry.used && entry.key == key ? &entry : nullptr;
+}
+
+void LiveAnalysis::store_proven(std::uint64_t key, bool won, int distance, Move best_move) {
+    proven[key & proven_mask] = Proven{
+        .key = key,
+        .best_move = best_move,
+        .distance = static_cast<std::uint16_t>(distance),
+        .used = true,
+        .won = won,
+    };
+}
+
+LiveReport LiveAnalysis::analyse(Field &field) {
+    field.show_available();
+    visits.clear();
+    component_stack.clear();
+    next_index = 0;
+    nodes = 0;
+    budget_exceeded = false;
+
+    Outcome outcome = search(field, 0);
+
+    LiveReport result{.hash = field.get_hash(), .nodes = nodes};
+    if (outcome == Outcome::won) {
+        // Written last on the way out, so nothing has overwritten it.
+        const Proven *root = find_proven(field.get_hash());
+        result.verdict = LiveVerdict::winnable;
+        result.best_move = root->best_move;
+        result.moves_to_win = root->distance;
+    } else if (outcome == Outcome::open) {
+        result.verdict = LiveVerdict::lost;
+    } else {
+        result.verdict = LiveVerdict::unknown;
+    }
+    return result;
+}
+
+LiveAnalysis::Outcome LiveAnalysis::search(Field &field, int depth) {
+    std::uint64_t key = field.get_hash();
+    if (field.is_finished()) {
+        store_proven(key, true);
+        return Outcome::won;
+    }
+    if (const Proven *known = find_proven(key)) {
+        return known->won ? Outcome::won : Outcome::open;
+    }
+
+    nodes++;
+    if ((nodes & 255) == 0 && generation.load(std::memory_order_relaxed) != search_generation) {
+        budget_exceeded = true;
+    }
+    if (nodes >= max_nodes || depth >= max_live_depth) {
+        budget_exceeded = true;
+    }
+    if (budget_exceeded) {
+        return Outcome::aborted;
+    }
+    if (is_dead(field)) {
+        store_proven(key, false);
+        return Outcome::open;
+    }
+
+    std::uint32_t index = next_index++;
+    visits[key] = Visit{index, index, true};
+    component_stack.push_back(key);
+    std::uint32_t lowlink = index;
+
+    // A lost verdict is kept for good, so it has to cover every legal move
+    // and not just the pruned list the solvers search.
+    MoveList moves;
+    MoveGen::generate(field, moves);
+    order_moves(field, moves);
+    for (Move move : moves) {
+        Undo undo = field.make(move);
+        std::uint64_t child = field.get_hash();
+
+        auto visit = visits.find(child);
+        if (visit != visits.end()) {
+            // Already entered this search: either still open on the stack,
+            // which ties it into our component, or already proven lost.
+            if (visit->second.on_stack) {
+                lowlink = std::min(lowlink, visit->second.index);
+            }
+            field.unmake(undo);
+            continue;
+        }
+
+        Outcome outcome = search(field, depth + 1);
+        field.unmake(undo);
+
+        if (outcome == Outcome::won) {
+            store_proven(key, true, find_proven(child)->distance + 1, move);
+            return Outcome::won;
+        }
+        if (outcome == Outcome::aborted) {
+            return Outcome::aborted;
+        }
+        if (auto after = visits.find(child); after != visits.end() && after->second.on_stack) {
+            lowlink = std::min(lowlink, after->second.lowlink);
+        }
+    }
+
+    visits[key].lowlink = lowlink;
+    if (lowlink == index) {
+        // Nothing below reaches back above us and nothing wins: the whole
+        // component is lost.
+        std::uint64_t member;
+        do {
+            member = component_stack.back();
+            component_stack.pop_back();
+            visits[member].on_stack = false;
+            store_proven(member, false);
+        } while (member != key);
+    }
+    return Outcome::open;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "field.h"
+#include "move.h"
+
+enum class LiveVerdict {
+    searching,
+    winnable,
+    lost,
+    unknown,
+};
+
+struct LiveReport {
+    std::uint64_t hash = 0;
+    LiveVerdict verdict = LiveVerdict::searching;
+    Move best_move;
+    // Length of the winning line found, not necessarily the shortest.
+    int moves_to_win = 0;
+    std::uint64_t nodes = 0;
+};
+
+// Analyses whatever position it was last given on a worker thread.
+//
+// Unlike Solver, the search keeps what it proves: positions on a winning
+// line are stored with their next move and distance, and positions whose
+// whole strongly connected component was searched without a win (Tarjan's
+// algorithm over the full move list) are stored as lost. Both stay true from
+// any root, so after a move the new search starts from everything learnt
+// so far; following the suggested move is answered straight from the table.
+//
+// set_position() and get_report() only hold a lock for a copy, so the UI
+// thread never waits on the search. A new position cancels the running
+// search within a few hundred nodes.
+class LiveAnalysis {
+public:
+    explicit LiveAnalysis(std::uint64_t max_nodes = 1'000'000, int proven_log2_entries = 20);
+    ~LiveAnalysis();
+
+    LiveAnalysis(const LiveAnalysis &) = delete;
+    LiveAnalysis &operator=(const LiveAnalysis &) = delete;
+
+    void set_position(const Field &field);
+    LiveReport get_report();
+
+private:
+    enum class Outcome {
+        won,
+        open,
+        aborted,
+    };
+
+    // Collisions just overwrite; a lost entry only costs a re-search.
+    struct Proven {
+        std::uint64_t key = 0;
+        Move best_move;
+        std::uint16_t distance = 0;
+        bool used = false;
+        bool won = false;
+    };
+
+    struct Visit {
+        std::uint32_t index = 0;
+        std::uint32_t lowlink = 0;
+        bool on_stack = false;
+    };
+
+    void run();
+    LiveReport analyse(Field &field);
+    Outcome search(Field &field, int depth);
+    void publish(const LiveReport &report);
+    const Proven *find_proven(std::uint64_t key) const;
+    void store_proven(std::uint64_t key, bool won, int distance = 0, Move best_move = {});
+
+    std::uint64_t max_nodes;
+
+    // Shared with the UI thread.
+    std::mutex mutex;
+    std::condition_variable wake;
+    Field target{empty_board};
+    std::atomic<std::uint64_t> generation = 0;
+    LiveReport report;
+    bool stop = false;
+
+    // Worker only.
+    std::vector<Proven> proven;
+    std::uint64_t proven_mask = 0;
+    std::unordered_map<std::uint64_t, Visit> visits;
+    std::vector<std::uint64_t> component_stack;
+    std::uint32_t next_index = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t search_generation = 0;
+    bool budget_exceeded = false;
+
+    std::thread worker;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include "card.h"
+
+enum class MoveKind : std::uint8_t {
+    tableau,
+    foundation,
+};
+
+// Lifts the card at (from_col, from_row) together with everything above it.
+// Tableau moves put the stack on top of `to_col`; foundation moves only ever
+// lift the front card and ignore `to_col`.
+struct Move {
+    std::uint8_t from_col = 0;
+    std::uint8_t from_row = 0;
+    std::uint8_t to_col = 0;
+    MoveKind kind = MoveKind::tableau;
+
+    constexpr Move() = default;
+    constexpr Move(int from_col, int from_row, int to_col, MoveKind kind)
+        : from_col(static_cast<std::uint8_t>(from_col)),
+          from_row(static_cast<std::uint8_t>(from_row)),
+          to_col(static_cast<std::uint8_t>(to_col)),
+          kind(kind) {
+    }
+
+    bool operator==(const Move &) const = default;
+};
+
+// Everything needed to take a move back exactly: the moved range starting at
+// `card`, where it landed and whether the move turned over the card it
+// uncovered.
+struct Undo {
+    Move move;
+    Card card;
+    std::uint8_t count = 0;
+    std::uint8_t to_row = 0;
+    bool revealed = false;
+};
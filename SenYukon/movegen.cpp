@@ -0,0 +1,66 @@
+#include <cassert>
+
+#include "movegen.h"
+
+void MoveGen::generate(const Field &field, MoveList &moves) {
+    moves.clear();
+
+    for (int col = 0; col < yukon_width; col++) {
+        if (field.can_feed_foundation(field.get_front(col))) {
+            moves.push(Move(col, field.height(col) - 1, col, MoveKind::foundation));
+        }
+    }
+
+    for (int to_col = 0; to_col < yukon_width; to_col++) {
+        Card front = field.top(to_col);
+
+        if (front.is_nil()) {
+            // A king already at the bottom of its column gains nothing from moving.
+            for (int suit = 0; suit < suit_count; suit++) {
+                int position = field.find(Card{suit * pips_per_suit + pip_king - 1});
+                if (field.is_face_up(position) && row_of(position) > 0) {
+                    moves.push(Move(column_of(position), row_of(position), to_col, MoveKind::tableau));
+                }
+            }
+            continue;
+        }
+        if (front.is_hidden()) {
+            continue;
+        }
+
+        for (int position : field.find(front.get_pip() - 1, front.get_color().opposite())) {
+            if (field.is_face_up(position) && column_of(position) != to_col) {
+                moves.push(Move(column_of(position), row_of(position), to_col, MoveKind::tableau));
+            }
+        }
+    }
+}
+
+bool MoveGen::is_legal(const Field &field, Move move) {
+    if (move.from_col >= yukon_width || move.to_col >= yukon_width) {
+        return false;
+    }
+
+    int position = position_of(move.from_col, move.from_row);
+    if (!field.is_face_up(position)) {
+        return false;
+    }
+
+    if (move.kind == MoveKind::foundation) {
+        return field.can_feed_foundation(position);
+    }
+
+    if (move.from_col == move.to_col) {
+        return false;
+    }
+
+    Card card = field.at(move.from_col, move.from_row);
+    Card front = field.top(move.to_col);
+    if (front.is_nil()) {
+        return card.get_pip() == pip_king && move.from_row > 0;
+    }
+    if (front.is_hidden()) {
+        return false;
+    }
+    return front.get_color() != card.get_color() && front.get_pip() == card.get_pip() + 1;
+}
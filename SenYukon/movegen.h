@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "field.h"
+#include "move.h"
+
+// Non-king cards fit on at most two fronts and the four kings on at most six
+// empty columns, plus one foundation move per column.
+static constexpr int max_moves = 48 * 2 + 4 * (yukon_width - 1) + yukon_width;
+
+class MoveList {
+    std::array<Move, max_moves> moves;
+    int count = 0;
+
+public:
+    void push(Move move) {
+        moves[static_cast<size_t>(count++)] = move;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    Move &operator[](int index) {
+        return moves[static_cast<size_t>(index)];
+    }
+
+    Move operator[](int index) const {
+        return moves[static_cast<size_t>(index)];
+    }
+
+    Move *begin() {
+        return moves.data();
+    }
+
+    Move *end() {
+        return moves.data() + count;
+    }
+
+    const Move *begin() const {
+        return moves.data();
+    }
+
+    const Move *end() const {
+        return moves.data() + count;
+    }
+};
+
+// Enumerates legal moves straight from the field's indices; no allocation and
+// no dependency on cursor or selection state.
+class MoveGen {
+public:
+    static void generate(const Field &field, MoveList &moves);
+    static bool is_legal(const Field &field, Move move);
+};
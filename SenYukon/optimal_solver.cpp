@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <climits>
+
+#include "deadlock.h"
+#include "optimal_solver.h"
+
+int solution_lower_bound(const Field &field) {
+    int bound = yukon_height;
+    for (int suit = 0; suit < foundation_count; suit++) {
+        bound -= field.foundation(suit).get_pip();
+    }
+
+    for (int col = 0; col < yukon_width; col++) {
+        std::array<int, suit_count> lowest;
+        lowest.fill(pip_king + 1);
+        for (int row = 0; row < field.height(col); row++) {
+            Card card = field.at(col, row);
+            int suit = static_cast<int>(card.get_suit());
+            if (card.get_pip() > lowest[suit]) {
+                bound++;
+                break;
+            }
+            lowest[suit] = card.get_pip();
+        }
+    }
+    return bound;
+}
+
+OptimalSolver::OptimalSolver(SolverLimits limits, int tt_log2_entries)
+    : limits(limits),
+      table(size_t{1} << tt_log2_entries),
+      mask((std::uint64_t{1} << tt_log2_entries) - 1) {
+    line.reserve(static_cast<size_t>(limits.max_depth));
+}
+
+SolveResult OptimalSolver::solve(const Field &field) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.max_seconds));
+    nodes = 0;
+    budget_exceeded = false;
+    line.clear();
+
+    Field root = field;
+    root.show_available();
+    bound = solution_lower_bound(root);
+
+    SolveResult result;
+    result.status = SolveStatus::timeout;
+    while (bound <= limits.max_depth) {
+        // Stamps keep counting across solves, so a reused table needs no
+        // clearing until they wrap.
+        if (++iteration == 0) {
+            std::fill(table.begin(), table.end(), Entry{});
+            iteration = 1;
+        }
+        next_bound = INT_MAX;
+        if (search(root, 0)) {
+            result.status = SolveStatus::solved;
+            result.solution = line;
+            break;
+        }
+        if (budget_exceeded) {
+            break;
+        }
+        if (next_bound == INT_MAX) {
+            result.status = SolveStatus::unsolvable;
+            break;
+        }
+        bound = next_bound;
+    }
+
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool OptimalSolver::out_of_budget() {
+    if (budget_exceeded) {
+        return true;
+    }
+    if (nodes >= limits.max_nodes) {
+        budget_exceeded = true;
+    } else if ((nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) {
+        budget_exceeded = true;
+    }
+    return budget_exceeded;
+}
+
+bool OptimalSolver::search(Field &field, int depth) {
+    if (field.is_finished()) {
+        return true;
+    }
+
+    int estimate = depth + solution_lower_bound(field);
+    if (estimate > bound) {
+        next_bound = std::min(next_bound, estimate);
+        return false;
+    }
+
+    nodes++;
+    if (out_of_budget()) {
+        return false;
+    }
+
+    // Reaching a position again no shallower than before cannot do better.
+    std::uint64_t key = search_key(field, limits);
+    Entry &entry = table[key & mask];
+    if (entry.iteration == iteration && entry.key == key && entry.depth <= depth) {
+        return false;
+    }
+    entry = Entry{key, iteration, static_cast<std::uint16_t>(depth)};
+
+    if (is_dead(field)) {
+        return false;
+    }
+
+    MoveList moves;
+    MoveGen::generate(field, moves);
+    for (Move move : moves) {
+        if (is_safe_foundation_move(field, move)) {
+            moves.clear();
+            moves.push(move);
+            break;
+        }
+    }
+
+    for (Move move : moves) {
+        line.push_back(move);
+        Undo undo = field.make(move);
+        bool solved = search(field, depth + 1);
+        field.unmake(undo);
+
+        if (solved) {
+            return true;
+        }
+        line.pop_back();
+        if (budget_exceeded) {
+            break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "field.h"
+#include "move.h"
+#include "solver.h"
+
+// Lower bound on the number of moves still needed: one foundation move per
+// card not yet home, plus one tableau move for every column where a card sits
+// above a lower card of its own suit, since the upper card has to be moved
+// off before the lower one can go up and no single move lifts cards from two
+// columns.
+int solution_lower_bound(const Field &field);
+
+// IDA* on solution_lower_bound. A solved result holds a shortest possible
+// move list; the search only plays a foundation move without branching when
+// no other card could ever be placed on it, which never lengthens a
+// solution.
+class OptimalSolver {
+public:
+    explicit OptimalSolver(SolverLimits limits = {}, int tt_log2_entries = 22);
+    SolveResult solve(const Field &field);
+
+private:
+    // Smallest depth a position was entered at during the current iteration.
+    // Entries from older iterations, including earlier solves, count as
+    // empty; collisions just overwrite.
+    struct Entry {
+        std::uint64_t key = 0;
+        std::uint32_t iteration = 0;
+        std::uint16_t depth = 0;
+    };
+
+    bool search(Field &field, int depth);
+    bool out_of_budget();
+
+    SolverLimits limits;
+    std::vector<Entry> table;
+    std::uint64_t mask = 0;
+    std::uint32_t iteration = 0;
+    int bound = 0;
+    int next_bound = 0;
+    std::vector<Move> line;
+    std::uint64_t nodes = 0;
+    bool budget_exceeded = false;
+    std::chrono::steady_clock::time_point deadline;
+};
@@ -0,0 +1,217 @@
+#include <thread>
+
+#include "deadlock.h"
+#include "parallel_solver.h"
+
+ParallelSolver::ParallelSolver(SolverLimits limits, int threads, int tt_log2_buckets)
+    : limits(limits),
+      table(tt_log2_buckets) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    thread_count = std::max(threads, 1);
+}
+
+SolveResult ParallelSolver::solve(const Field &field) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.max_seconds));
+    stop = false;
+    solved = false;
+    budget_exceeded = false;
+    depth_exceeded = false;
+    idle_workers = 0;
+    total_nodes = 0;
+    solution.clear();
+    table.clear();
+
+    workers.clear();
+    for (int i = 0; i < thread_count; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->line.reserve(static_cast<size_t>(limits.max_depth));
+    }
+
+    Field root = field;
+    root.show_available();
+    pending_tasks = 1;
+    push_task(0, Task{root, {}});
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; i++) {
+        threads.emplace_back(&ParallelSolver::run_worker, this, i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    SolveResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.threads = thread_count;
+    for (auto &worker : workers) {
+        result.nodes += worker->nodes;
+        result.steals += worker->steals;
+        result.tt_probes += worker->tt_probes;
+        result.tt_hits += worker->tt_hits;
+    }
+    if (solved) {
+        result.status = SolveStatus::solved;
+        result.solution = solution;
+    } else if (budget_exceeded || depth_exceeded) {
+        result.status = SolveStatus::timeout;
+    } else {
+        result.status = SolveStatus::unsolvable;
+    }
+    workers.clear();
+    return result;
+}
+
+void ParallelSolver::run_worker(int index) {
+    Worker &worker = *workers[index];
+    Task task;
+    bool idle = false;
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        if (pop_task(index, task)) {
+            if (idle) {
+                idle_workers.fetch_sub(1, std::memory_order_relaxed);
+                idle = false;
+            }
+            worker.line = std::move(task.line);
+            if (search(worker, index, task.field, static_cast<int>(worker.line.size()))) {
+                report_solution(worker.line);
+            }
+            pending_tasks.fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+
+        // Nothing queued anywhere and nobody still searching means the whole
+        // tree has been covered.
+        if (pending_tasks.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+        if (!idle) {
+            idle_workers.fetch_add(1, std::memory_order_relaxed);
+            idle = true;
+        }
+        std::this_thread::yield();
+    }
+
+    if (idle) {
+        idle_workers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    total_nodes.fetch_add(worker.unreported_nodes, std::memory_order_relaxed);
+    worker.unreported_nodes = 0;
+}
+
+// Own work comes off the back of the deque, stolen work off the front, so
+// thieves take the shallowest and largest subtrees.
+bool ParallelSolver::pop_task(int index, Task &task) {
+    {
+        Worker &worker = *workers[index];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int i = 1; i < thread_count; i++) {
+        Worker &victim = *workers[(index + i) % thread_count];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            workers[index]->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelSolver::push_task(int index, Task &&task) {
+    Worker &worker = *workers[index];
+    std::lock_guard lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+}
+
+bool ParallelSolver::out_of_budget(Worker &worker) {
+    if (stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (++worker.unreported_nodes < 1024) {
+        return false;
+    }
+
+    std::uint64_t nodes = total_nodes.fetch_add(worker.unreported_nodes, std::memory_order_relaxed) + worker.unreported_nodes;
+    worker.unreported_nodes = 0;
+    if (nodes >= limits.max_nodes || std::chrono::steady_clock::now() >= deadline) {
+        budget_exceeded = true;
+        stop = true;
+        return true;
+    }
+    return false;
+}
+
+void ParallelSolver::report_solution(const std::vector<Move> &line) {
+    std::lock_guard lock(solution_mutex);
+    if (!solved) {
+        solution = line;
+        solved = true;
+        stop = true;
+    }
+}
+
+bool ParallelSolver::search(Worker &worker, int index, Field &field, int depth) {
+    if (field.is_finished()) {
+        return true;
+    }
+
+    worker.nodes++;
+    if (out_of_budget(worker)) {
+        return false;
+    }
+    if (depth >= limits.max_depth) {
+        depth_exceeded = true;
+        return false;
+    }
+
+    worker.tt_probes++;
+    if (!table.claim(search_key(field, limits))) {
+        worker.tt_hits++;
+        return false;
+    }
+    if (is_dead(field)) {
+        return false;
+    }
+
+    MoveList moves;
+    generate_search_moves(field, moves, limits.weights);
+
+    for (int i = 0; i < moves.size(); i++) {
+        if (i > 0 && idle_workers.load(std::memory_order_relaxed) > 0) {
+            // Someone is starving: hand over the siblings we have not tried.
+            for (int j = i; j < moves.size(); j++) {
+                Task task{field, worker.line};
+                task.field.make(moves[j]);
+                task.line.push_back(moves[j]);
+                pending_tasks.fetch_add(1, std::memory_order_relaxed);
+                push_task(index, std::move(task));
+            }
+            break;
+        }
+
+        worker.line.push_back(moves[i]);
+        Undo undo = field.make(moves[i]);
+        bool found = search(worker, index, field, depth + 1);
+        field.unmake(undo);
+
+        if (found) {
+            return true;
+        }
+        worker.line.pop_back();
+        if (stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "field.h"
+#include "move.h"
+#include "solver.h"
+
+// The same search as Solver, spread over a work-stealing pool. Every worker
+// owns a deque of subtrees; it works depth-first on its own and hands out the
+// untried siblings of its current node whenever another worker sits idle.
+// All workers share one lock-free transposition table, so a position
+// entered by any thread is never searched again.
+class ParallelSolver {
+public:
+    // `threads` <= 0 uses every hardware thread.
+    explicit ParallelSolver(SolverLimits limits = {}, int threads = 0, int tt_log2_buckets = 21);
+    SolveResult solve(const Field &field);
+
+private:
+    struct Task {
+        Field field{empty_board};
+        std::vector<Move> line;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::vector<Move> line;
+        std::uint64_t nodes = 0;
+        std::uint64_t unreported_nodes = 0;
+        std::uint64_t steals = 0;
+        std::uint64_t tt_probes = 0;
+        std::uint64_t tt_hits = 0;
+    };
+
+    void run_worker(int index);
+    bool pop_task(int index, Task &task);
+    void push_task(int index, Task &&task);
+    bool search(Worker &worker, int index, Field &field, int depth);
+    bool out_of_budget(Worker &worker);
+    void report_solution(const std::vector<Move> &line);
+
+    SolverLimits limits;
+    int thread_count = 1;
+    TranspositionTable table;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<bool> stop = false;
+    std::atomic<bool> solved = false;
+    std::atomic<bool> budget_exceeded = false;
+    std::atomic<bool> depth_exceeded = false;
+    std::atomic<int> pending_tasks = 0;
+    std::atomic<int> idle_workers = 0;
+    std::atomic<std::uint64_t> total_nodes = 0;
+    std::chrono::steady_clock::time_point deadline;
+
+    std::mutex solution_mutex;
+    std::vector<Move> solution;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// splitmix64: one word of state, fast, and every seed starts its own
+// well-mixed stream, which makes it a good fit for numbered deals.
+class FastRng {
+    std::uint64_t state;
+
+public:
+    explicit FastRng(std::uint64_t seed)
+        : state(seed) {
+    }
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E37'79B9'7F4A'7C15);
+        z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EB;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound) by multiply-shift; the bias is below bound / 2^32.
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+};
+
+// A fresh deal number. The random device is only read once per thread.
+inline std::uint64_t random_deal_number() {
+    thread_local FastRng rng{(std::uint64_t{std::random_device()()} << 32) ^ std::random_device()()};
+    return rng.next();
+}
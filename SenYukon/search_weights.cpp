@@ -0,0 +1,29 @@
+#include <fstream>
+
+#include "search_weights.h"
+
+bool load_search_weights(const std::string &filename, SearchWeights &weights) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+
+    std::string name;
+    int value = 0;
+    while (file >> name >> value) {
+        for (const SearchWeightField &field : search_weight_fields) {
+            if (name == field.name) {
+                weights.*field.member = value;
+            }
+        }
+    }
+    return true;
+}
+
+bool save_search_weights(const std::string &filename, const SearchWeights &weights) {
+    std::ofstream file(filename);
+    for (const SearchWeightField &field : search_weight_fields) {
+        file << field.name << ' ' << weights.*field.member << '\n';
+    }
+    return static_cast<bool>(file);
+}
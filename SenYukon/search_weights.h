@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+// Move-ordering weights for the depth-first searches. A move's score is the
+// sum of the weights of the features it has; higher scores are tried first.
+// The defaults are the hand-picked values; the Tuner measures better ones.
+struct SearchWeights {
+    int foundation = 100;
+    // Turning over a face-down card, plus a bonus per card still face down
+    // in that column.
+    int reveal = 50;
+    int reveal_per_hidden = 1;
+    // Emptying a column.
+    int empty_column = 20;
+    // Moving off a matching card, which only trades it for the other one.
+    int split_run = -30;
+    // Moving onto an empty column.
+    int to_empty_column = 0;
+    // Per card moved.
+    int moved_card = 0;
+
+    bool operator==(const SearchWeights &) const = default;
+};
+
+struct SearchWeightField {
+    const char *name;
+    int SearchWeights::*member;
+};
+
+// Every weight by name, for the file format and the Tuner.
+inline constexpr std::array<SearchWeightField, 7> search_weight_fields = {{
+    {"foundation", &SearchWeights::foundation},
+    {"reveal", &SearchWeights::reveal},
+    {"reveal_per_hidden", &SearchWeights::reveal_per_hidden},
+    {"empty_column", &SearchWeights::empty_column},
+    {"split_run", &SearchWeights::split_run},
+    {"to_empty_column", &SearchWeights::to_empty_column},
+    {"moved_card", &SearchWeights::moved_card},
+}};
+
+// Plain text, one "name value" pair per line; names not in the file keep
+// their current value. Returns false if the file cannot be read.
+bool load_search_weights(const std::string &filename, SearchWeights &weights);
+bool save_search_weights(const std::string &filename, const SearchWeights &weights);
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cassert>
+
+#include "canonical.h"
+#include "deadlock.h"
+#include "solver.h"
+
+TranspositionTable::TranspositionTable(int log2_buckets)
+    : entries(std::make_unique<std::atomic<std::uint64_t>[]>(size_t{bucket_size} << log2_buckets)),
+      mask((std::uint64_t{1} << log2_buckets) - 1) {
+    clear();
+}
+
+// Zero marks an empty slot.
+static std::uint64_t table_key(std::uint64_t key) {
+    return key ? key : 1;
+}
+
+bool TranspositionTable::contains(std::uint64_t key) const {
+    key = table_key(key);
+    const std::atomic<std::uint64_t> *bucket = &entries[(key & mask) * bucket_size];
+    for (int i = 0; i < bucket_size; i++) {
+        if (bucket[i].load(std::memory_order_relaxed) == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::insert(std::uint64_t key) {
+    claim(key);
+}
+
+// Inserts `key` and reports whether it was missing, so of several threads
+// reaching the same position only one goes on to search it.
+bool TranspositionTable::claim(std::uint64_t key) {
+    key = table_key(key);
+    std::atomic<std::uint64_t> *bucket = &entries[(key & mask) * bucket_size];
+    for (int i = 0; i < bucket_size; i++) {
+        std::uint64_t slot = bucket[i].load(std::memory_order_relaxed);
+        if (slot == 0 && bucket[i].compare_exchange_strong(slot, key, std::memory_order_relaxed)) {
+            return true;
+        }
+        if (slot == key) {
+            return false;
+        }
+    }
+    bucket[(key >> 60) % bucket_size].store(key, std::memory_order_relaxed);
+    return true;
+}
+
+void TranspositionTable::clear() {
+    for (std::uint64_t i = 0; i < (mask + 1) * bucket_size; i++) {
+        entries[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// A card may go up for good once no card could still want to be placed on
+// it: aces always, anything else when both opposite-colour piles have caught
+// up to one below it. Twos are no exception; in Yukon an ace can carry a
+// stack onto one, which may be the only way to uncover what lies beneath.
+bool is_safe_foundation_move(const Field &field, Move move) {
+    if (move.kind != MoveKind::foundation) {
+        return false;
+    }
+
+    Card card = field.at(move.from_col, move.from_row);
+    if (card.get_pip() == pip_ace) {
+        return true;
+    }
+
+    for (int suit = 0; suit < foundation_count; suit++) {
+        Card pile = field.foundation(suit);
+        if (Card{suit * pips_per_suit}.get_color() == card.get_color()) {
+            continue;
+        }
+        if (pile.get_pip() < card.get_pip() - 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int score_move(const Field &field, Move move, const SearchWeights &weights) {
+    if (move.kind == MoveKind::foundation) {
+        return weights.foundation;
+    }
+
+    int score = 0;
+    int hidden_below = field.hidden_count(move.from_col);
+    if (move.from_row == hidden_below && hidden_below > 0) {
+        score += weights.reveal + weights.reveal_per_hidden * hidden_below;
+    }
+    if (move.from_row == 0) {
+        score += weights.empty_column;
+    }
+    if (move.from_row > 0 && field.is_tied(move.from_col, move.from_row - 1)) {
+        score += weights.split_run;
+    }
+    if (field.height(move.to_col) == 0) {
+        score += weights.to_empty_column;
+    }
+    score += weights.moved_card * (field.height(move.from_col) - move.from_row);
+    return score;
+}
+
+void order_moves(const Field &field, MoveList &moves, const SearchWeights &weights) {
+    std::array<int, max_moves> scores;
+    for (int i = 0; i < moves.size(); i++) {
+        scores[i] = score_move(field, moves[i], weights);
+    }
+
+    // Insertion sort; the lists are short and mostly ordered already.
+    for (int i = 1; i < moves.size(); i++) {
+        Move move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        for (; j >= 0 && scores[j] < score; j--) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+// Legal moves in search order, or just the safe foundation move if there is one.
+void generate_search_moves(const Field &field, MoveList &moves, const SearchWeights &weights) {
+    MoveGen::generate(field, moves);
+
+    for (Move move : moves) {
+        if (is_safe_foundation_move(field, move)) {
+            moves.clear();
+            moves.push(move);
+            return;
+        }
+    }
+    order_moves(field, moves, weights);
+}
+
+std::uint64_t search_key(const Field &field, const SolverLimits &limits) {
+    return limits.use_symmetry ? canonical_hash(field) : field.get_hash();
+}
+
+Solver::Solver(SolverLimits limits, int tt_log2_buckets)
+    : limits(limits),
+      table(tt_log2_buckets) {
+    line.reserve(static_cast<size_t>(limits.max_depth));
+}
+
+SolveResult Solver::solve(const Field &field) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.max_seconds));
+    nodes = 0;
+    budget_exceeded = false;
+    depth_exceeded = false;
+    line.clear();
+    table.clear();
+
+    Field root = field;
+    root.show_available();
+    bool solved = search(root, 0);
+
+    SolveResult result;
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (solved) {
+        result.status = SolveStatus::solved;
+        result.solution = line;
+    } else if (budget_exceeded || depth_exceeded) {
+        result.status = SolveStatus::timeout;
+    } else {
+        result.status = SolveStatus::unsolvable;
+    }
+    return result;
+}
+
+bool Solver::out_of_budget() {
+    if (budget_exceeded) {
+        return true;
+    }
+    if (nodes >= limits.max_nodes) {
+        budget_exceeded = true;
+    } else if ((nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) {
+        budget_exceeded = true;
+    }
+    return budget_exceeded;
+}
+
+bool Solver::search(Field &field, int depth) {
+    if (field.is_finished()) {
+        return true;
+    }
+
+    nodes++;
+    if (out_of_budget()) {
+        return false;
+    }
+    if (depth >= limits.max_depth) {
+        depth_exceeded = true;
+        return false;
+    }
+
+    // Positions are marked on entry, which is all a reachability search needs.
+    if (!table.claim(search_key(field, limits))) {
+        return false;
+    }
+    if (is_dead(field)) {
+        return false;
+    }
+
+    MoveList moves;
+    generate_search_moves(field, moves, limits.weights);
+
+    for (Move move : moves) {
+        line.push_back(move);
+        Undo undo = field.make(move);
+        bool solved = search(field, depth + 1);
+        field.unmake(undo);
+
+        if (solved) {
+            return true;
+        }
+        line.pop_back();
+        if (budget_exceeded) {
+            break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "field.h"
+#include "move.h"
+#include "movegen.h"
+#include "search_weights.h"
+
+enum class SolveStatus {
+    solved,
+    unsolvable,
+    timeout,
+};
+
+struct SolverLimits {
+    std::uint64_t max_nodes = 10'000'000;
+    double max_seconds = 5.0;
+    int max_depth = 400;
+    // Key the transposition table on canonical_hash, so positions that only
+    // differ by column order or same-colour suit swaps are searched once.
+    bool use_symmetry = true;
+    SearchWeights weights;
+};
+
+struct SolveResult {
+    SolveStatus status = SolveStatus::timeout;
+    std::vector<Move> solution;
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+
+    // Filled in by the parallel search.
+    int threads = 1;
+    std::uint64_t steals = 0;
+    std::uint64_t tt_probes = 0;
+    std::uint64_t tt_hits = 0;
+};
+
+// Set of position hashes the search has already entered. Buckets of four
+// slots; when a bucket is full one entry gets overwritten, which only costs a
+// re-search later. Slots are plain atomics, so any number of threads can
+// share one table without locking.
+class TranspositionTable {
+    static constexpr int bucket_size = 4;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> entries;
+    std::uint64_t mask = 0;
+
+public:
+    explicit TranspositionTable(int log2_buckets);
+    bool contains(std::uint64_t key) const;
+    void insert(std::uint64_t key);
+    bool claim(std::uint64_t key);
+    void clear();
+};
+
+// Depth-first search over the full-information position (hidden cards
+// included). Foundation moves that nothing else can depend on are played
+// without branching, positions that failed are remembered in the
+// transposition table, and positions find_sealed_column proves lost are cut.
+class Solver {
+public:
+    explicit Solver(SolverLimits limits = {}, int tt_log2_buckets = 20);
+    SolveResult solve(const Field &field);
+
+private:
+    bool search(Field &field, int depth);
+    bool out_of_budget();
+
+    SolverLimits limits;
+    TranspositionTable table;
+    std::vector<Move> line;
+    std::uint64_t nodes = 0;
+    bool budget_exceeded = false;
+    bool depth_exceeded = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+bool is_safe_foundation_move(const Field &field, Move move);
+// Sorts legal moves into search order, most promising first.
+void order_moves(const Field &field, MoveList &moves, const SearchWeights &weights = {});
+void generate_search_moves(const Field &field, MoveList &moves, const SearchWeights &weights = {});
+std::uint64_t search_key(const Field &field, const SolverLimits &limits);
@@ -1,17 +1,17 @@
 #include <cassert>
 #include <algorithm>
+#include <bit>
+#include <iomanip>
 #include <sstream>
+#include <string_view>
 
+#include "deadlock.h"
 #include "state.h"
 
 #include "raymath.h"
 #include "sound_manager.h"
 #include "resource_manager.h"
 
-struct DrawPathInfo {
-    std::array<int, yukon_width> final_depth_display_count;
-};
-
 static constexpr std::array pip_keys = {
     /* order is very important - do not change it! */
     KEY_ONE,
@@ -29,6 +29,8 @@ static constexpr std::array pip_keys = {
     KEY_K,
 };
 
+static constexpr std::string_view sealed_column_warning = " can never be uncovered, this game is lost";
+
 static constexpr bool is_key_pip(int key) {
     for (int k : pip_keys) {
         if (key == k) {
@@ -70,7 +72,7 @@ State::State() {
     ResourceManager::startup_singleton();
     SoundManager::startup_singleton(ResourceManager::get_singleton());
     bgm = LoadMusicStream("bgm.ogg");
-    prev_time = GetTime();
+    load_search_weights("weights.txt", search_weights);
 }
 
 State::~State() {
@@ -85,6 +87,7 @@ void State::handle_input() {
         handle_yukon_movement();
         break;
     case StateMode::animating:
+    case StateMode::searching:
         break;
     }
 
@@ -92,16 +95,31 @@ void State::handle_input() {
 }
 
 void State::update() {
-    if (field_when_path_created != main_field) {
+    if (should_draw_path && field_when_path_created != main_field) {
         should_draw_path = false;
+        chain_search.cancel();
     }
 
     main_camera.offset = Vector2{GetRenderWidth() / 2.0f, GetRenderHeight() / 2.0f};
 
+    if (mode == StateMode::searching) {
+        if (BackgroundTask::Finish finish = button_task.take_finished()) {
+            mode = StateMode::waiting;
+            finish();
+        }
+    }
+
     if (mode == StateMode::waiting) {
         if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
             if (CheckCollisionPointRec(GetMousePosition(), reset_button)) {
-                main_field = {};
+                if (std::optional<std::uint64_t> deal = deal_pool.try_pop()) {
+                    main_field = Field(*deal);
+                    status_message = (std::stringstream() << "INFO: Deal #" << *deal << " (winnable)").str();
+                } else {
+                    main_field = {};
+                    status_message = "INFO: Random deal, not yet checked";
+                }
+                clear_history();
             }
             if (CheckCollisionPointRec(GetMousePosition(), auto_button)) {
                 animation = std::make_unique<Animation>(main_field, 0.1);
@@ -120,8 +138,38 @@ void State::update() {
                 status_message = "INFO: Saved game data as \"save\"";
             }
             if (CheckCollisionPointRec(GetMousePosition(), load_button)) {
-                main_field.load_from_file("save");
-                status_message = "INFO: Loaded game data from \"save\"";
+                if (main_field.load_from_file("save")) {
+                    main_field.show_available();
+                    clear_history();
+                    status_message = "INFO: Loaded game data from \"save\"";
+                } else {
+                    status_message = "ERROR: Cannot read game data from \"save\"";
+                    SoundManager::get_singleton()->play_sound("sfx/error.wav");
+                }
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), undo_button)) {
+                undo();
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), redo_button)) {
+                redo();
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), solve_button)) {
+                solve();
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), shortest_button)) {
+                solve_shortest();
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), easy_button)) {
+                new_deal(Difficulty::easy);
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), medium_button)) {
+                new_deal(Difficulty::medium);
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), hard_button)) {
+                new_deal(Difficulty::hard);
+            }
+            if (CheckCollisionPointRec(GetMousePosition(), hint_button)) {
+                hint();
             }
         }
     }
@@ -141,6 +189,22 @@ void State::update() {
     }
 
     main_field_is_finished_prev_frame = main_field.is_finished();
+
+    // Only from the face-up cards, so the warning never gives away what lies
+    // under them.
+    int sealed_column = find_visibly_sealed_column(main_field);
+    if (sealed_column != nil && !main_field_was_dead_prev_frame) {
+        status_message = (std::stringstream() << "WARNING: Column " << sealed_column + 1 << sealed_column_warning).str();
+    } else if (sealed_column == nil && main_field_was_dead_prev_frame && status_message.ends_with(sealed_column_warning)) {
+        // Only take back our own warning, not whatever replaced it since.
+        status_message = "";
+    }
+    main_field_was_dead_prev_frame = sealed_column != nil;
+
+    if (main_field.get_hash() != live_analysis_hash) {
+        live_analysis_hash = main_field.get_hash();
+        live_analysis.set_position(main_field);
+    }
     UpdateMusicStream(bgm);
 }
 
@@ -162,30 +226,25 @@ void State::render() {
         if (selected == nil) {
             Card cursor_card = main_field[cursor];
             if (!cursor_card.is_nil() && !cursor_card.is_hidden()) {
-                for (int y = 0; y < yukon_height; y++) {
-                    for (int x = 0; x < yukon_width; x++) {
-                        Card card = main_field[y * yukon_width + x];
-                        bool should_be_highlighted = true;
-                        should_be_highlighted = should_be_highlighted && !card.is_nil();
-                        should_be_highlighted = should_be_highlighted && !card.is_hidden();
-                        should_be_highlighted = should_be_highlighted && cursor_card.get_color() != card.get_color();
-                        should_be_highlighted = should_be_highlighted && cursor_card.get_pip() + 1 == card.get_pip();
-                        if (should_be_highlighted) {
-                            Color color = Color{0, 228, 48, (unsigned char)((sin(GetTime() * 5.0) + 1.0) * 25.0)};
-                            DrawRectangle(x * cell_width, y * cell_height + cell_height, cell_width, cell_height, color);
-                        }
+                for (int position : main_field.find(cursor_card.get_pip() + 1, cursor_card.get_color().opposite())) {
+                    if (main_field.is_face_up(position)) {
+                        Color color = Color{0, 228, 48, (unsigned char)((sin(GetTime() * 5.0) + 1.0) * 25.0)};
+                        DrawRectangle(column_of(position) * cell_width, row_of(position) * cell_height + cell_height, cell_width, cell_height, color);
                     }
                 }
             }
             
             if (should_draw_path) {
-                draw_path(base_path);
+                draw_path();
             }
         }
         break;
     case StateMode::animating:
         animation->render();
         break;
+    case StateMode::searching:
+        main_field.render();
+        break;
     }
 
     Vector2 world_mouse = GetScreenToWorld2D(GetMousePosition(), main_camera);
@@ -208,6 +267,11 @@ void State::render() {
 
     DrawText(status_message.c_str(), int(status_message_box.x), int(status_message_box.y), int(status_message_box.height), WHITE);
 
+    float analysis_box_height = 30.0f;
+    Rectangle analysis_box{0.0f, status_message_box.y - analysis_box_height, float(GetRenderWidth()), analysis_box_height};
+    DrawRectangleRec(analysis_box, DARKGRAY);
+    DrawText(describe_live_report().c_str(), int(analysis_box.x + 5.0f), int(analysis_box.y), int(analysis_box.height), WHITE);
+
     Vector2 mousePosition = GetMousePosition();
 
     bool reset_button_collision = CheckCollisionPointRec(mousePosition, reset_button);
@@ -230,6 +294,42 @@ void State::render() {
     DrawRectangleRec(load_button, load_button_collision ? WHITE : GRAY);
     DrawText("Load", int(load_button.x + 5.0f), int(load_button.y), int(load_button.height), load_button_collision ? BLACK : WHITE);
 
+    bool undo_button_collision = CheckCollisionPointRec(mousePosition, undo_button);
+    DrawRectangleRec(undo_button, undo_button_collision ? WHITE : GRAY);
+    DrawText("Undo", int(undo_button.x + 5.0f), int(undo_button.y), int(undo_button.height), undo_button_collision ? BLACK : WHITE);
+
+    bool redo_button_collision = CheckCollisionPointRec(mousePosition, redo_button);
+    DrawRectangleRec(redo_button, redo_button_collision ? WHITE : GRAY);
+    DrawText("Redo", int(redo_button.x + 5.0f), int(redo_button.y), int(redo_button.height), redo_button_collision ? BLACK : WHITE);
+
+    bool solve_button_collision = CheckCollisionPointRec(mousePosition, solve_button);
+    DrawRectangleRec(solve_button, solve_button_collision ? WHITE : GRAY);
+    DrawText("Solve", int(solve_button.x + 5.0f), int(solve_button.y), int(solve_button.height), solve_button_collision ? BLACK : WHITE);
+
+    bool shortest_button_collision = CheckCollisionPointRec(mousePosition, shortest_button);
+    DrawRectangleRec(shortest_button, shortest_button_collision ? WHITE : GRAY);
+    DrawText("Shortest", int(shortest_button.x + 5.0f), int(shortest_button.y), int(shortest_button.height), shortest_button_collision ? BLACK : WHITE);
+
+    bool easy_button_collision = CheckCollisionPointRec(mousePosition, easy_button);
+    DrawRectangleRec(easy_button, easy_button_collision ? WHITE : GRAY);
+    DrawText("Easy", int(easy_button.x + 5.0f), int(easy_button.y), int(easy_button.height), easy_button_collision ? BLACK : WHITE);
+
+    bool medium_button_collision = CheckCollisionPointRec(mousePosition, medium_button);
+    DrawRectangleRec(medium_button, medium_button_collision ? WHITE : GRAY);
+    DrawText("Medium", int(medium_button.x + 5.0f), int(medium_button.y), int(medium_button.height), medium_button_collision ? BLACK : WHITE);
+
+    bool hard_button_collision = CheckCollisionPointRec(mousePosition, hard_button);
+    DrawRectangleRec(hard_button, hard_button_collision ? WHITE : GRAY);
+    DrawText("Hard", int(hard_button.x + 5.0f), int(hard_button.y), int(hard_button.height), hard_button_collision ? BLACK : WHITE);
+
+    bool hint_button_collision = CheckCollisionPointRec(mousePosition, hint_button);
+    DrawRectangleRec(hint_button, hint_button_collision ? WHITE : GRAY);
+    DrawText("Hint", int(hint_button.x + 5.0f), int(hint_button.y), int(hint_button.height), hint_button_collision ? BLACK : WHITE);
+
+    if (mode == StateMode::waiting && is_x_in && is_y_in && focus_y < main_field.hidden_count(focus_x)) {
+        DrawText(describe_hidden_card(focus_x, focus_y).c_str(), int(mousePosition.x + 15.0f), int(mousePosition.y), 20, YELLOW);
+    }
+
     EndMode2D();
 }
 
@@ -264,9 +364,7 @@ void State::handle_yukon_movement() {
             cursor = cursor % yukon_width; // get the top of yukon col
         } else {
             cursor = cursor % yukon_width; // get the top of yukon col
-            while (main_field[cursor].is_hidden()) {
-                cursor += yukon_width;
-            }
+            cursor = position_of(cursor, main_field.hidden_count(cursor));
         }
     }
 
@@ -288,10 +386,11 @@ void State::handle_yukon_movement() {
 
         } else {
             should_draw_path = false;
+            chain_search.cancel();
         }
     }
 
-    if (IsKeyPressed(KEY_Z)) {
+    if (IsKeyPressed(KEY_Z) && !IsKeyDown(KEY_LEFT_CONTROL) && !IsKeyDown(KEY_RIGHT_CONTROL)) {
         if (can_update_path()) {
             update_path();
         }
@@ -324,7 +423,7 @@ void State::handle_yukon_movement() {
                         animation = std::make_unique<Animation>(main_field, 0.05);
                         animation->record_frame(Animation::Movement(cursor, yukon_size + (int)main_field[cursor].get_suit()));
                         mode = StateMode::animating;
-                        main_field.feed_foundation(cursor);
+                        apply_move(Move(column_of(cursor), row_of(cursor), column_of(cursor), MoveKind::foundation));
                     }
                     selected = nil;
                     break;
@@ -337,7 +436,7 @@ void State::handle_yukon_movement() {
                     break;
                 }
                 make_swap_animation(selected, front);
-                main_field.swap(selected, front);
+                apply_move(Move(column_of(selected), row_of(selected), column_of(front), MoveKind::tableau));
                 selected = nil;
             } while (false);
         } else {
@@ -347,7 +446,7 @@ void State::handle_yukon_movement() {
                         animation = std::make_unique<Animation>(main_field, 0.05);
                         animation->record_frame(Animation::Movement(cursor, yukon_size + (int)main_field[cursor].get_suit()));
                         mode = StateMode::animating;
-                        main_field.feed_foundation(cursor);
+                        apply_move(Move(column_of(cursor), row_of(cursor), column_of(cursor), MoveKind::foundation));
                     }
                     selected = nil;
                     break;
@@ -357,14 +456,18 @@ void State::handle_yukon_movement() {
                     break;
                 }
                 make_swap_animation(selected, front);
-                main_field.swap(selected, front + raw_size);
+                apply_move(Move(column_of(selected), row_of(selected), column_of(front), MoveKind::tableau));
                 selected = nil;
             } while (false);
         }
+    }
 
-        if (selected == nil) {
-            main_field.show_available();
-        }
+    bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    if (control && IsKeyPressed(KEY_Z)) {
+        undo();
+    }
+    if (control && IsKeyPressed(KEY_Y)) {
+        redo();
     }
 
     if (IsKeyPressed(KEY_F5)) {
@@ -376,28 +479,25 @@ void State::handle_yukon_movement() {
         int pip = key_to_pip(key);
         if (is_key_pip(key)) {
 
+            // Jump to the next face-up card of that pip further down the
+            // cursor's column, wrapping around to the top.
             bool found = false;
-            int c = cursor + yukon_width;
-            for (;;) {
-                if (c >= yukon_size) {
-                    c = c % yukon_width;
+            int origin = cursor;
+            int best_distance = yukon_height + 1;
+            for (int suit = 0; suit < suit_count; suit++) {
+                int position = main_field.find(Card{suit * pips_per_suit + pip - 1});
+                if (!main_field.is_face_up(position) || column_of(position) != column_of(origin)) {
+                    continue;
                 }
-
-                found = true;
-                found = found && !main_field[c].is_nil();
-                found = found && !main_field[c].is_hidden();
-                found = found && main_field[c].get_pip() == pip;
-
-                if (found) {
-                    cursor = c;
-                    break;
+                int distance = (row_of(position) - row_of(origin) + yukon_height) % yukon_height;
+                if (distance == 0) {
+                    distance = yukon_height;
                 }
-
-                if (c == cursor) {
-                    break;
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    cursor = position;
+                    found = true;
                 }
-
-                c += yukon_width;
             }
 
             if (found) {
@@ -457,117 +557,240 @@ void State::auto_feed() {
                     /* to */   yukon_size + (int)main_field[front].get_suit()
                 };
                 animation->record_frame(std::move(movement));
-                main_field.feed_foundation(front);
+                apply_move(Move(col, row_of(front), col, MoveKind::foundation));
                 cont = true;
             }
         }
     }
-
-    main_field.show_available();
 }
 
-Path State::collect_path(int cur, int depth, Path *prev) {
-    Path result;
+void State::apply_move(Move move) {
+    history.resize(history_position);
+    history.push_back(main_field.make(move));
+    belief.apply(main_field, history.back());
+    history_position++;
+}
 
-    result.position = cur;
-    if (prev) {
-        result.previous_path = prev;
+void State::undo() {
+    if (history_position == 0) {
+        status_message = "ERROR: Nothing to undo";
+        SoundManager::get_singleton()->play_sound("sfx/error.wav");
+        return;
     }
+    main_field.unmake(history[--history_position]);
+    belief.retract(main_field, history[history_position]);
+    selected = nil;
+    status_message = "";
+    SoundManager::get_singleton()->play_sound("sfx/cancel.wav");
+}
 
-    if (depth >= max_path_depth || depth < 0) {
-        return result;
+void State::redo() {
+    if (history_position == history.size()) {
+        status_message = "ERROR: Nothing to redo";
+        SoundManager::get_singleton()->play_sound("sfx/error.wav");
+        return;
     }
+    history[history_position] = main_field.make(history[history_position].move);
+    belief.apply(main_field, history[history_position]);
+    history_position++;
+    selected = nil;
+    status_message = "";
+    SoundManager::get_singleton()->play_sound("sfx/move.wav");
+}
 
-    Card card = main_field[cur];
-    if (card.is_nil() || card.is_hidden()) {
-        return result;
+// Called whenever main_field is replaced, so it also forgets what was seen.
+void State::clear_history() {
+    history.clear();
+    history_position = 0;
+    belief.reset(main_field);
+}
+
+// The slow buttons search a copy of the position on button_task; the game
+// stays as it is until the result comes back in update().
+void State::start_search(const char *message, BackgroundTask::Job job) {
+    status_message = message;
+    selected = nil;
+    mode = StateMode::searching;
+    button_task.start(std::move(job));
+}
+
+void State::new_deal(Difficulty level) {
+    start_search("INFO: Looking for a deal...", [this, level]() -> BackgroundTask::Finish {
+        std::optional<RatedDeal> deal = find_deal(level, deal_search_seconds);
+        return [this, level, deal]() {
+            if (!deal) {
+                status_message = (std::stringstream() << "ERROR: No " << difficulty_name(level) << " deal found in time").str();
+                SoundManager::get_singleton()->play_sound("sfx/error.wav");
+                return;
+            }
+
+            main_field = Field(deal->deal_number);
+            clear_history();
+            status_message = (std::stringstream() << "INFO: Deal #" << deal->deal_number << ", " << difficulty_name(level)
+                                                   << " (score " << std::fixed << std::setprecision(0) << deal->rating.score << ")")
+                                 .str();
+        };
+    });
+}
+
+void State::solve() {
+    if (main_field.is_finished()) {
+        return;
     }
 
-    std::vector<int> next;
+    start_search("INFO: Solving...", [this, field = main_field]() -> BackgroundTask::Finish {
+        if (!solve_button_solver) {
+            SolverLimits limits = solve_button_limits;
+            limits.weights = search_weights;
+            solve_button_solver = std::make_unique<ParallelSolver>(limits);
+        }
+        SolveResult result = solve_button_solver->solve(field);
+        return [this, result]() {
+            if (result.status == SolveStatus::solved) {
+                play_solution(result.solution);
+                status_message = (std::stringstream() << "INFO: Solved in " << result.solution.size() << " moves ("
+                                                       << result.nodes << " nodes, " << result.threads << " threads, "
+                                                       << std::fixed << std::setprecision(0) << result.nodes / std::max(result.seconds, 1e-6) << " nodes/s)")
+                                     .str();
+                return;
+            }
+            report_failed_solve(result);
+        };
+    });
+}
 
-    int next_pip = card.get_pip() + 1;
-    SuitColor next_color = card.get_color().opposite();
+void State::solve_shortest() {
+    if (main_field.is_finished()) {
+        return;
+    }
 
-    do {
-        if (next_pip == 14) {
-            if (cur % yukon_width == cur) {
-                break;
+    start_search("INFO: Searching for the shortest solution...", [this, field = main_field]() -> BackgroundTask::Finish {
+        if (!shortest_button_solver) {
+            shortest_button_solver = std::make_unique<OptimalSolver>(shortest_button_limits);
+        }
+        SolveResult result = shortest_button_solver->solve(field);
+        return [this, result]() {
+            if (result.status == SolveStatus::solved) {
+                play_solution(result.solution);
+                status_message = (std::stringstream() << "INFO: Shortest solution is " << result.solution.size() << " moves ("
+                                                       << result.nodes << " nodes)")
+                                     .str();
+                return;
             }
-            for (int x = 0; x < yukon_width; x++) {
-                if (main_field[x].is_hidden())
-                    continue;
-                if (main_field[x].get_pip() == pip_king)
-                    continue;
-                next.push_back(x);
+            report_failed_solve(result);
+        };
+    });
+}
+
+// Unlike the solve buttons this only uses what the player can see; the
+// hidden cards are sampled rather than read.
+void State::hint() {
+    if (main_field.is_finished()) {
+        return;
+    }
+
+    start_search("INFO: Thinking...", [this, field = main_field, seen = belief]() -> BackgroundTask::Finish {
+        HintLimits limits = hint_button_limits;
+        limits.weights = search_weights;
+        HintEngine engine(limits);
+        HintResult result = engine.suggest(field, seen);
+        return [this, result]() {
+            if (!result.has_move) {
+                status_message = "ERROR: No moves left";
+                SoundManager::get_singleton()->play_sound("sfx/error.wav");
+                return;
             }
-            break;
-        }
 
-        for (int i = 0; i < yukon_size; i++) {
-            Card ca = main_field[i];
-
-            if (ca.is_nil())
-                continue;
-            if (ca.is_hidden())
-                continue;
-            if (ca.get_color() != next_color)
-                continue;
-            if (ca.get_pip() != next_pip)
-                continue;
-            if (!main_field[i + yukon_width].is_nil()) {
-                main_field[i + yukon_width];
+            Move move = result.move;
+            int samples = 0;
+            for (const MoveEstimate &estimate : result.moves) {
+                samples += estimate.samples;
             }
-            if ((i % yukon_width) == (cur % yukon_width)) {
-                if (i + yukon_width >= yukon_size || main_field[i + yukon_width].is_nil()) {
-                    next.push_back(i);
-                }
+            cursor = position_of(move.from_col, move.from_row);
+            std::stringstream message;
+            message << "INFO: Hint: " << main_field.at(move.from_col, move.from_row).get_label();
+            if (move.kind == MoveKind::foundation) {
+                message << " to foundation";
             } else {
-                if (i + yukon_width < yukon_size) {
-                    next.push_back(i + yukon_width);
-                }
+                message << " to column " << move.to_col + 1;
             }
-        }
-    } while (0);
+            message << " (" << std::fixed << std::setprecision(0) << result.win_probability * 100.0 << "% to win, "
+                    << samples << " samples)";
+            status_message = message.str();
+        };
+    });
+}
 
-    for (auto c : next) {
-        bool to_continue = false;
-        Path *p = &result;
-        while (p->previous_path) {
-            p = p->previous_path;
-            
-            if (c == p->position) {
-                to_continue = true;
-                break;
-            }
-        }
-        if (to_continue) {
-            continue;
-        }
+void State::play_solution(const std::vector<Move> &solution) {
+    animation = std::make_unique<Animation>(main_field, 0.05);
+    for (Move move : solution) {
+        animation->record_move(main_field, move);
+        apply_move(move);
+    }
+    selected = nil;
+    mode = StateMode::animating;
+}
 
-        auto path = collect_path(c, depth + 1, &result);
-        result.next_paths.push_back(path);
+void State::report_failed_solve(const SolveResult &result) {
+    if (result.status == SolveStatus::unsolvable) {
+        status_message = "ERROR: This game can no longer be won";
+    } else {
+        status_message = (std::stringstream() << "ERROR: No solution found within " << result.nodes << " nodes").str();
+    }
+    SoundManager::get_singleton()->play_sound("sfx/error.wav");
+}
+
+std::string State::describe_live_report() {
+    LiveReport report = live_analysis.get_report();
+    if (report.hash != main_field.get_hash()) {
+        return "Analysing...";
     }
 
-    return result;
+    switch (report.verdict) {
+    case LiveVerdict::searching:
+        return "Analysing...";
+    case LiveVerdict::lost:
+        return "Lost: no sequence of moves wins from here";
+    case LiveVerdict::unknown:
+        return (std::stringstream() << "Undecided after " << report.nodes << " nodes").str();
+    case LiveVerdict::winnable:
+        break;
+    }
+
+    if (report.moves_to_win == 0) {
+        return "Won";
+    }
+    Move move = report.best_move;
+    std::stringstream text;
+    text << "Winnable in " << report.moves_to_win << " moves, best: "
+         << main_field.at(move.from_col, move.from_row).get_label();
+    if (move.kind == MoveKind::foundation) {
+        text << " to foundation";
+    } else {
+        text << " to column " << move.to_col + 1;
+    }
+    return text.str();
 }
 
-bool State::delete_useless_paths(Path &path) {
-    std::vector<std::vector<Path>::iterator> pathToDelete;
+std::string State::describe_hidden_card(int col, int row) const {
+    Card card = belief.seen_card(col, row);
+    if (!card.is_nil()) {
+        return (std::stringstream() << "Seen before: " << card.get_label()).str();
+    }
 
-    for (int i = 0; i < path.next_paths.size(); i++) {
-        if (delete_useless_paths(path.next_paths[i])) {
-            path.next_paths.erase(path.next_paths.begin() + i);
-            i--;
+    CardMask candidates = belief.candidates(col, row);
+    int count = std::popcount(candidates);
+    if (count > 4) {
+        return (std::stringstream() << "One of " << count << " unseen cards").str();
+    }
+    std::stringstream text;
+    text << "One of";
+    for (int raw = 0; raw < hidden; raw++) {
+        if ((candidates >> raw) & 1) {
+            text << " " << Card{raw}.get_label();
         }
     }
-
-    if (!path.next_paths.empty())
-        return false;
-    if (path.position == nil)
-        return true;
-    if (main_field[path.position].is_nil())
-        return false;
-    return true;
+    return text.str();
 }
 
 bool State::can_update_path() {
@@ -580,8 +803,7 @@ bool State::can_update_path() {
 
 void State::update_path() {
     should_draw_path = true;
-    base_path = collect_path(cursor);
-    delete_useless_paths(base_path);
+    path_request = chain_search.request(main_field, cursor, max_path_depth);
     time_path_created = GetTime();
     field_when_path_created = main_field;
     path_depth_tracker = 0;
@@ -589,22 +811,15 @@ void State::update_path() {
 
 static constexpr double animation_speed = 15.0;
 
-void State::draw_path(const Path &path, int depth, DrawPathInfo *info) {
-    if (depth > path_depth_tracker) {
-        path_depth_tracker = depth;
-        SoundManager::get_singleton()->play_sound("sfx/path.wav");
-    }
-    
-    bool created_info = false;
-
-    if (info == nullptr) {
-        info = new DrawPathInfo();
-        created_info = true;
-    }
-
-    if (GetTime() - ((double)depth / animation_speed) < time_path_created) {
+void State::draw_path() {
+    // Until the worker has answered the current request there is nothing to
+    // show; older answers are for another cursor or field.
+    const ChainSnapshot &snapshot = chain_search.read();
+    if (snapshot.request != path_request) {
         return;
     }
+    const ChainGraph &path_graph = snapshot.graph;
+    double time_since_path_created = GetTime() - time_path_created;
 
     auto position_to_vec = [](int position) -> Vector2 {
         Vector2 result{};
@@ -613,28 +828,41 @@ void State::draw_path(const Path &path, int depth, DrawPathInfo *info) {
         return result;
     };
 
-    for (auto &next : path.next_paths) {
-        Vector2 from = position_to_vec(path.position);
-        Vector2 to = position_to_vec(next.position);
+    // Edges come ordered by depth, so each depth starts animating once the
+    // one before it has had its turn.
+    for (const ChainEdge &edge : path_graph.get_edges()) {
+        if (!path_graph.is_useful(edge.to)) {
+            continue;
+        }
+        int depth = path_graph.depth(edge.from);
+        if (time_since_path_created < depth / animation_speed) {
+            break;
+        }
+        if (depth > path_depth_tracker) {
+            path_depth_tracker = depth;
+            SoundManager::get_singleton()->play_sound("sfx/path.wav");
+        }
+
+        Vector2 from = position_to_vec(edge.from);
+        Vector2 to = position_to_vec(edge.to);
 
         Color color = LIME;
         float normalized_depth = -((float)depth / (float)max_path_depth) + 1.0f;
-        float time_since_path_created = GetTime() - time_path_created;
         Vector2 animated_point = Vector2Lerp(from, to, Clamp((time_since_path_created - (((float)depth) / animation_speed)) * animation_speed, 0.0f, 1.0f));
         color = Fade(color, normalized_depth);
         DrawLineEx(from, animated_point, 4.0f * normalized_depth, color);
-
-        if (main_field[next.position].is_nil()) {
-            auto &count = info->final_depth_display_count[next.position % yukon_width];
-            DrawTextEx(GetFontDefault(), std::to_string(depth + 1).c_str(), Vector2Add(to, Vector2{1.0f, 30.0f + 30.0f * count}), 30, 1.0f, LIME);
-            count++;
-        }
-
-        draw_path(next, depth + 1, info);
     }
 
-    if (created_info) {
-        delete info;
+    // Every empty slot a chain ends in, labelled with the number of moves.
+    std::array<int, yukon_width> label_counts = {};
+    for (std::int16_t position : path_graph.get_positions()) {
+        int depth = path_graph.depth(position);
+        if (depth == 0 || !main_field[position].is_nil() || time_since_path_created < (depth - 1) / animation_speed) {
+            continue;
+        }
+        int &count = label_counts[position % yukon_width];
+        DrawTextEx(GetFontDefault(), std::to_string(depth).c_str(), Vector2Add(position_to_vec(position), Vector2{1.0f, 30.0f + 30.0f * count}), 30, 1.0f, LIME);
+        count++;
     }
 }
 
@@ -6,22 +6,43 @@
 #include <raylib.h>
 
 #include "animation.h"
+#include "belief_state.h"
+#include "async_chain_search.h"
+#include "background_task.h"
+#include "deal_pool.h"
+#include "difficulty.h"
 #include "field.h"
+#include "hint_engine.h"
+#include "live_analysis.h"
+#include "move.h"
+#include "optimal_solver.h"
+#include "parallel_solver.h"
+#include "solver.h"
 
 enum class StateMode {
     waiting,
     animating,
+    // A button's search runs on button_task; input waits for it.
+    searching,
 };
 
-static constexpr int max_path_depth = 16;
+static constexpr int max_path_depth = 32;
 
-struct Path {
-    int position = nil;
-    std::vector<Path> next_paths{};
-    Path *previous_path = nullptr;
+static constexpr SolverLimits solve_button_limits = {
+    .max_nodes = 5'000'000,
+    .max_seconds = 2.0,
 };
 
-struct DrawPathInfo;
+static constexpr double deal_search_seconds = 1.5;
+
+static constexpr SolverLimits shortest_button_limits = {
+    .max_nodes = 20'000'000,
+    .max_seconds = 5.0,
+};
+
+static constexpr HintLimits hint_button_limits = {
+    .max_seconds = 1.0,
+};
 
 class State {
 public:
@@ -32,12 +53,32 @@ public:
     Field main_field;
     Camera2D main_camera = {.zoom = 1.0f};
     StateMode mode = StateMode::waiting;
-    Path base_path;
+    AsyncChainSearch chain_search;
+    std::uint64_t path_request = 0;
     int path_base_position = nil;
     double time_path_created = 0.0;
     bool should_draw_path = false;
-    Field field_when_path_created;
+    Field field_when_path_created{empty_board};
     int path_depth_tracker = 0;
+    std::vector<Undo> history;
+    size_t history_position = 0;
+    BeliefState belief{main_field};
+    // Move ordering for the solve and hint buttons, from weights.txt if the
+    // Tuner has written one.
+    SearchWeights search_weights;
+    // Built on the first click and kept, so later clicks reuse the table
+    // and sessions that never solve do not pay for it.
+    std::unique_ptr<ParallelSolver> solve_button_solver;
+    // Also built on the first click; its table is stamped per iteration, so
+    // reusing it skips the clear too.
+    std::unique_ptr<OptimalSolver> shortest_button_solver;
+    // Declared after the solvers it uses, so it is joined before they go.
+    BackgroundTask button_task;
+    bool main_field_was_dead_prev_frame = false;
+
+    DealPool deal_pool;
+    LiveAnalysis live_analysis;
+    std::uint64_t live_analysis_hash = 0;
 
     // animation stuff
     std::unique_ptr<Animation> animation;
@@ -48,6 +89,14 @@ public:
     static constexpr Rectangle music_toggle_button = {auto_button.x + auto_button.width + 10, 10, 120, 40};
     static constexpr Rectangle save_button = {music_toggle_button.x + music_toggle_button.width + 10, 10, 120, 40};
     static constexpr Rectangle load_button = {save_button.x + save_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle undo_button = {load_button.x + load_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle redo_button = {undo_button.x + undo_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle solve_button = {redo_button.x + redo_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle shortest_button = {solve_button.x + solve_button.width + 10, 10, 170, 40};
+    static constexpr Rectangle easy_button = {shortest_button.x + shortest_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle medium_button = {easy_button.x + easy_button.width + 10, 10, 160, 40};
+    static constexpr Rectangle hard_button = {medium_button.x + medium_button.width + 10, 10, 120, 40};
+    static constexpr Rectangle hint_button = {hard_button.x + hard_button.width + 10, 10, 110, 40};
 
     // audio stuff
     bool main_field_is_finished_prev_frame = false;
@@ -66,13 +115,24 @@ private:
     void handle_camera_movement();
 
     void auto_feed();
+    void apply_move(Move move);
+    void undo();
+    void redo();
+    void clear_history();
+    void start_search(const char *message, BackgroundTask::Job job);
+    void new_deal(Difficulty level);
+    void solve();
+    void solve_shortest();
+    void hint();
+    void play_solution(const std::vector<Move> &solution);
+    void report_failed_solve(const SolveResult &result);
+    std::string describe_live_report();
+    std::string describe_hidden_card(int col, int row) const;
     
 
-    Path collect_path(int cur, int depth=0, Path *prev=nullptr);
-    bool delete_useless_paths(Path &path);
     bool can_update_path();
     void update_path();
-    void draw_path(const Path &path, int depth = 0, DrawPathInfo *info = nullptr);
+    void draw_path();
 
     void make_swap_animation(int selected, int front);
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Hands the newest value from one writer thread to one reader thread without
+// locks. The writer fills write_buffer() and publishes it; the reader picks
+// up whatever was published last and keeps reading it until something newer
+// arrives. Values the reader never got to are simply overwritten.
+template <typename T>
+class TripleBuffer {
+    static constexpr int index_mask = 3;
+    // Set on the middle index when it holds a value the reader has not taken.
+    static constexpr int fresh_bit = 4;
+
+    std::array<T, 3> buffers = {};
+    std::atomic<int> middle = 1;
+    int back = 0;
+    int front = 2;
+
+public:
+    // Writer side. The buffer may hold any older value and must be
+    // overwritten completely.
+    T &write_buffer() {
+        return buffers[back];
+    }
+
+    void publish() {
+        back = middle.exchange(back | fresh_bit, std::memory_order_acq_rel) & index_mask;
+    }
+
+    // Reader side. Swaps in the newest published value, if there is one.
+    const T &read() {
+        if (middle.load(std::memory_order_relaxed) & fresh_bit) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+        }
+        return buffers[front];
+    }
+};
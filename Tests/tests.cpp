@@ -0,0 +1,468 @@
+// Tests for move generation, make/unmake, hashing, chain graphs and the
+// search and position analysis. Plain checks with no framework: every
+// failure is printed and the exit code is nonzero if any check failed.
+//
+//     Tests
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include "canonical.h"
+#include "chain_graph.h"
+#include "deadlock.h"
+#include "field.h"
+#include "movegen.h"
+#include "rng.h"
+#include "solver.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": FAILED: " #condition "\n"; \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+static Card card(Suit suit, int pip) {
+    return Card{static_cast<int>(suit) * pips_per_suit + pip - 1};
+}
+
+// Pushes pips `from` down to `to` of one suit, so `to` ends up in front.
+static void push_run(Field &field, int col, Suit suit, int from, int to) {
+    for (int pip = from; pip >= to; pip--) {
+        field.push(col, card(suit, pip));
+    }
+}
+
+// The black ace carries C5 onto the red two, which is the only way to reach
+// C4 below it. Sending the two up first, as the old "twos are always safe"
+// rule forced, leaves the deal lost.
+static Field ace_needs_red_two() {
+    Field field{empty_board};
+    field.push(0, card(Suit::heart, 6).hide());
+    field.push(0, card(Suit::club, 4).hide());
+    field.push(0, card(Suit::spade, pip_ace));
+    field.push(0, card(Suit::club, 5));
+    field.push(1, card(Suit::heart, 2));
+    push_run(field, 2, Suit::spade, pip_king, 2);
+    push_run(field, 3, Suit::club, pip_king, 6);
+    push_run(field, 4, Suit::heart, pip_king, 7);
+    push_run(field, 5, Suit::heart, 5, 3);
+    field.fill_foundation(static_cast<int>(Suit::heart), card(Suit::heart, pip_ace));
+    field.fill_foundation(static_cast<int>(Suit::diamond), card(Suit::diamond, pip_king));
+    field.fill_foundation(static_cast<int>(Suit::club), card(Suit::club, 3));
+    field.show_available();
+    return field;
+}
+
+static void test_two_is_not_always_safe() {
+    Field field = ace_needs_red_two();
+
+    MoveList moves;
+    generate_search_moves(field, moves);
+    bool ace_onto_two = false;
+    for (Move move : moves) {
+        ace_onto_two |= move == Move(0, 2, 1, MoveKind::tableau);
+    }
+    CHECK(ace_onto_two);
+
+    Solver solver;
+    CHECK(solver.solve(field).status == SolveStatus::solved);
+}
+
+// S10 can only go onto HJ, face down under C8, and C8 only onto H9 or D9,
+// face down under S10. Neither column's reasoning holds on its own; it takes
+// assuming both sealed to see that they stay so.
+static Field mutual_blocking() {
+    Field field{empty_board};
+    field.push(0, card(Suit::heart, 9).hide());
+    field.push(0, card(Suit::diamond, 9).hide());
+    field.push(0, card(Suit::diamond, 11).hide());
+    field.push(0, card(Suit::spade, 10));
+    field.push(1, card(Suit::heart, 11).hide());
+    field.push(1, card(Suit::spade, 9).hide());
+    field.push(1, card(Suit::club, 7).hide());
+    field.push(1, card(Suit::club, 8));
+    push_run(field, 2, Suit::spade, pip_king, 11);
+    push_run(field, 3, Suit::heart, pip_king, 12);
+    field.push(3, card(Suit::heart, 10));
+    push_run(field, 4, Suit::diamond, pip_king, 12);
+    field.push(4, card(Suit::diamond, 10));
+    push_run(field, 5, Suit::club, pip_king, 9);
+    field.fill_foundation(static_cast<int>(Suit::spade), card(Suit::spade, 8));
+    field.fill_foundation(static_cast<int>(Suit::heart), card(Suit::heart, 8));
+    field.fill_foundation(static_cast<int>(Suit::diamond), card(Suit::diamond, 8));
+    field.fill_foundation(static_cast<int>(Suit::club), card(Suit::club, 6));
+    field.show_available();
+    return field;
+}
+
+static void test_mutual_blocking_is_sealed() {
+    Field field = mutual_blocking();
+    CHECK(find_sealed_column(field) != nil);
+
+    Solver solver;
+    CHECK(solver.solve(field).status == SolveStatus::unsolvable);
+
+    // A won deal keeps nothing sealed.
+    CHECK(find_sealed_column(ace_needs_red_two()) == nil);
+}
+
+// Positions along random playouts of a few deals, so the checks below see
+// every stage of a game and not just fresh deals.
+template <typename Visit>
+static void for_random_positions(int deals, int moves_per_deal, Visit visit) {
+    FastRng rng{12345};
+    for (int deal = 1; deal <= deals; deal++) {
+        Field field(static_cast<std::uint64_t>(deal));
+        field.show_available();
+        visit(field);
+        for (int i = 0; i < moves_per_deal; i++) {
+            MoveList moves;
+            MoveGen::generate(field, moves);
+            if (moves.empty()) {
+                break;
+            }
+            field.make(moves[static_cast<int>(rng.below(static_cast<std::uint32_t>(moves.size())))]);
+            visit(field);
+        }
+    }
+}
+
+// Lays the cards of `field` out again one push at a time, with `map` applied
+// to every card and `columns[col]` giving where column `col` goes, so the
+// incremental state can be checked against a fresh build.
+template <typename Map>
+static Field rebuild(const Field &field, Map map, const std::array<int, yukon_width> &columns) {
+    Field built{empty_board};
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < field.height(col); row++) {
+            built.push(columns[col], map(field.at(col, row)));
+        }
+    }
+    for (int suit = 0; suit < foundation_count; suit++) {
+        Card top = field.foundation(suit);
+        if (!top.is_nil()) {
+            Card mapped = map(top);
+            built.fill_foundation(static_cast<int>(mapped.get_suit()), mapped);
+        }
+    }
+    return built;
+}
+
+static constexpr std::array<int, yukon_width> same_columns = {0, 1, 2, 3, 4, 5, 6};
+
+static Card same_card(Card card) {
+    return card;
+}
+
+// Trades hearts for diamonds, keeping face-down cards face down.
+static Card swap_reds(Card card) {
+    if (card.is_nil()) {
+        return card;
+    }
+    Card shown = card.show();
+    int suit = static_cast<int>(shown.get_suit());
+    if (suit == static_cast<int>(Suit::heart)) {
+        suit = static_cast<int>(Suit::diamond);
+    } else if (suit == static_cast<int>(Suit::diamond)) {
+        suit = static_cast<int>(Suit::heart);
+    }
+    Card mapped{suit * pips_per_suit + shown.get_pip() - 1};
+    return card.is_hidden() ? mapped.hide() : mapped;
+}
+
+static bool same_layout(const Field &a, const Field &b) {
+    for (int col = 0; col < yukon_width; col++) {
+        if (a.height(col) != b.height(col) || a.hidden_count(col) != b.hidden_count(col)) {
+            return false;
+        }
+        for (int row = 0; row < a.height(col); row++) {
+            if (a.at(col, row).get_raw() != b.at(col, row).get_raw() || a.is_tied(col, row) != b.is_tied(col, row)) {
+                return false;
+            }
+        }
+    }
+    for (int suit = 0; suit < foundation_count; suit++) {
+        if (a.foundation(suit).get_raw() != b.foundation(suit).get_raw()) {
+            return false;
+        }
+    }
+    for (int raw = 0; raw < pips_per_suit * suit_count; raw++) {
+        if (a.find(Card{raw}) != b.find(Card{raw})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every move generate() lists is legal, nothing is listed twice, and every
+// legal move it could have listed is there.
+static void test_generate_matches_is_legal() {
+    int mismatches = 0;
+    for_random_positions(40, 60, [&](const Field &field) {
+        MoveList moves;
+        MoveGen::generate(field, moves);
+        for (int i = 0; i < moves.size(); i++) {
+            mismatches += !MoveGen::is_legal(field, moves[i]);
+            for (int j = 0; j < i; j++) {
+                mismatches += moves[i] == moves[j];
+            }
+        }
+
+        int legal = 0;
+        for (int from_col = 0; from_col < yukon_width; from_col++) {
+            for (int from_row = 0; from_row < field.height(from_col); from_row++) {
+                legal += MoveGen::is_legal(field, Move(from_col, from_row, from_col, MoveKind::foundation));
+                for (int to_col = 0; to_col < yukon_width; to_col++) {
+                    legal += MoveGen::is_legal(field, Move(from_col, from_row, to_col, MoveKind::tableau));
+                }
+            }
+        }
+        mismatches += legal != moves.size();
+    });
+    CHECK(mismatches == 0);
+
+    Field field = ace_needs_red_two();
+    CHECK(!MoveGen::is_legal(field, Move(0, 0, 1, MoveKind::tableau)));      // face down
+    CHECK(!MoveGen::is_legal(field, Move(0, 3, 0, MoveKind::tableau)));      // onto itself
+    CHECK(!MoveGen::is_legal(field, Move(0, 2, 0, MoveKind::foundation)));   // not the front card
+    CHECK(MoveGen::is_legal(field, Move(1, 0, 1, MoveKind::foundation)));    // H2 onto HA
+    CHECK(!MoveGen::is_legal(field, Move(2, 0, 6, MoveKind::tableau)));      // king already at the bottom
+}
+
+// make() followed by unmake() restores the exact position, and the state
+// make() keeps up incrementally matches laying the result out from scratch.
+static void test_make_unmake_round_trip() {
+    int mismatches = 0;
+    int moves_checked = 0;
+    for_random_positions(30, 80, [&](const Field &field) {
+        MoveList moves;
+        MoveGen::generate(field, moves);
+        for (Move move : moves) {
+            Field played = field;
+            Undo undo = played.make(move);
+            Field built = rebuild(played, same_card, same_columns);
+            mismatches += !same_layout(played, built) || played.get_hash() != built.get_hash();
+            mismatches += canonical_hash(played) != canonical_hash(built);
+
+            played.unmake(undo);
+            mismatches += !same_layout(played, field) || played.get_hash() != field.get_hash();
+            moves_checked++;
+        }
+    });
+    CHECK(moves_checked > 10'000);
+    CHECK(mismatches == 0);
+}
+
+// Reordering columns or trading the two red suits leaves the canonical hash
+// alone; the plain hash tells the positions apart.
+static void test_canonical_hash_invariance() {
+    constexpr std::array<int, yukon_width> reversed = {6, 5, 4, 3, 2, 1, 0};
+    int mismatches = 0;
+    int distinct = 0;
+    for_random_positions(20, 40, [&](const Field &field) {
+        Field moved = rebuild(field, same_card, reversed);
+        Field swapped = rebuild(field, swap_reds, same_columns);
+        Field both = rebuild(field, swap_reds, reversed);
+        std::uint64_t key = canonical_hash(field);
+        mismatches += canonical_hash(moved) != key;
+        mismatches += canonical_hash(swapped) != key;
+        mismatches += canonical_hash(both) != key;
+        distinct += swapped.get_hash() != field.get_hash();
+    });
+    CHECK(mismatches == 0);
+    CHECK(distinct > 0);
+
+    // One card's place is real information.
+    Field field(7);
+    field.show_available();
+    MoveList moves;
+    MoveGen::generate(field, moves);
+    CHECK(!moves.empty());
+    Field played = field;
+    played.make(moves[0]);
+    CHECK(canonical_hash(played) != canonical_hash(field));
+}
+
+// Checks BoardChains and ChainGraph against brute-force versions of their
+// definitions: successors, distances to an empty slot, the depth of every
+// position reached, the edges between consecutive depths and which
+// positions are useful.
+static void test_chain_graph_output() {
+    int mismatches = 0;
+    int graphs = 0;
+    BoardChains board;
+    ChainGraph graph;
+    for_random_positions(10, 40, [&](const Field &field) {
+        board.build(field);
+        CHECK(board.is_built_for(field));
+
+        std::array<std::vector<int>, yukon_size> successors;
+        for (int position = 0; position < yukon_size; position++) {
+            std::array<int, yukon_width> found;
+            int count = chain_successors(field, position, found);
+            successors[position].assign(found.begin(), found.begin() + count);
+            auto listed = board.successors(position);
+            mismatches += !std::equal(listed.begin(), listed.end(), successors[position].begin(), successors[position].end());
+        }
+
+        // Distances by relaxing until nothing changes.
+        std::array<int, yukon_size> distance;
+        for (int position = 0; position < yukon_size; position++) {
+            distance[position] = field[position].is_nil() ? 0 : nil;
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (int position = 0; position < yukon_size; position++) {
+                for (int to : successors[position]) {
+                    if (distance[to] != nil && (distance[position] == nil || distance[to] + 1 < distance[position])) {
+                        distance[position] = distance[to] + 1;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        for (int position = 0; position < yukon_size; position++) {
+            mismatches += board.distance(position) != distance[position];
+        }
+
+        for (int root = 0; root < yukon_size; root++) {
+            if (!field.is_face_up(root)) {
+                continue;
+            }
+            for (int max_depth : {1, 3, 8}) {
+                graph.build(board, root, max_depth);
+                graphs++;
+
+                std::array<int, yukon_size> depth;
+                depth.fill(nil);
+                depth[root] = 0;
+                std::vector<int> queue = {root};
+                for (size_t i = 0; i < queue.size(); i++) {
+                    for (int to : successors[queue[i]]) {
+                        if (depth[to] == nil) {
+                            depth[to] = depth[queue[i]] + 1;
+                            queue.push_back(to);
+                        }
+                    }
+                }
+
+                // The graph enters what can still reach an empty slot in
+                // time, links consecutive depths, and keeps what those links
+                // lead to an empty slot.
+                std::array<bool, yukon_size> entered;
+                std::array<bool, yukon_size> useful;
+                for (int position = 0; position < yukon_size; position++) {
+                    entered[position] = depth[position] != nil && distance[position] != nil && depth[position] + distance[position] <= max_depth;
+                    useful[position] = entered[position] && distance[position] == 0;
+                }
+                int expected_edges = 0;
+                for (int from = 0; from < yukon_size; from++) {
+                    for (int to : successors[from]) {
+                        expected_edges += entered[from] && entered[to] && depth[to] == depth[from] + 1;
+                    }
+                }
+                for (bool changed = true; changed;) {
+                    changed = false;
+                    for (int from = 0; from < yukon_size; from++) {
+                        for (int to : successors[from]) {
+                            if (entered[from] && !useful[from] && useful[to] && depth[to] == depth[from] + 1) {
+                                useful[from] = true;
+                                changed = true;
+                            }
+                        }
+                    }
+                }
+
+                int deepest = 0;
+                for (int position = 0; position < yukon_size; position++) {
+                    mismatches += graph.is_useful(position) != useful[position];
+                    if (entered[position]) {
+                        mismatches += graph.depth(position) != depth[position];
+                    }
+                    if (useful[position]) {
+                        deepest = std::max(deepest, depth[position]);
+                    }
+                }
+                mismatches += graph.get_max_depth() != deepest;
+
+                for (ChainEdge edge : graph.get_edges()) {
+                    mismatches += graph.depth(edge.to) != graph.depth(edge.from) + 1;
+                    mismatches += std::find(successors[edge.from].begin(), successors[edge.from].end(), edge.to) == successors[edge.from].end();
+                }
+                mismatches += static_cast<int>(graph.get_edges().size()) != expected_edges;
+            }
+        }
+    });
+    CHECK(graphs > 1000);
+    CHECK(mismatches == 0);
+}
+
+// Both columns hiding the cards S10 and C8 need are sealed, so the proof
+// holds without knowing which face-down card is where. Once a third column
+// has face-down cards, HJ or a red nine could be there instead.
+static void test_visibly_sealed_needs_no_hidden_cards() {
+    Field field = mutual_blocking();
+    CHECK(find_visibly_sealed_column(field) != nil);
+
+    Field field_with_third = field;
+    field_with_third.clear();
+    for (int col = 0; col < yukon_width; col++) {
+        for (int row = 0; row < field.height(col); row++) {
+            Card card = field.at(col, row);
+            // The king at the bottom of column 5 turns face down.
+            field_with_third.push(col, col == 5 && row == 0 ? card.hide() : card);
+        }
+    }
+    for (int suit = 0; suit < foundation_count; suit++) {
+        field_with_third.fill_foundation(suit, field.foundation(suit));
+    }
+    CHECK(find_sealed_column(field_with_third) != nil);
+    CHECK(find_visibly_sealed_column(field_with_third) == nil);
+
+    // Anything proven from the face-up cards alone is true of the real layout,
+    // and stays proven however the face-down cards are swapped around.
+    int mismatches = 0;
+    int proven = 0;
+    FastRng rng{99};
+    for_random_positions(200, 400, [&](const Field &position) {
+        int sealed = find_visibly_sealed_column(position);
+        proven += sealed != nil;
+        mismatches += sealed != nil && find_sealed_column(position) == nil;
+
+        Field shuffled = position;
+        for (int i = 0; i < 8; i++) {
+            int col1 = static_cast<int>(rng.below(yukon_width));
+            int col2 = static_cast<int>(rng.below(yukon_width));
+            if (shuffled.hidden_count(col1) > 0 && shuffled.hidden_count(col2) > 0) {
+                shuffled.swap_hidden(col1, static_cast<int>(rng.below(static_cast<std::uint32_t>(shuffled.hidden_count(col1)))),
+                                     col2, static_cast<int>(rng.below(static_cast<std::uint32_t>(shuffled.hidden_count(col2)))));
+            }
+        }
+        mismatches += (find_visibly_sealed_column(shuffled) != nil) != (sealed != nil);
+    });
+    CHECK(proven > 0);
+    CHECK(mismatches == 0);
+}
+
+int main() {
+    test_two_is_not_always_safe();
+    test_mutual_blocking_is_sealed();
+    test_visibly_sealed_needs_no_hidden_cards();
+    test_generate_matches_is_legal();
+    test_make_unmake_round_trip();
+    test_canonical_hash_invariance();
+    test_chain_graph_output();
+
+    if (failures) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "all tests passed\n";
+    return 0;
+}
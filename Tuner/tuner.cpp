@@ -0,0 +1,227 @@
+// Self-play tuner for the search move ordering. Solves a fixed batch of
+// seeded deals on every core with a candidate SearchWeights and keeps any
+// change that solves more deals within the node budget, or as many in fewer
+// nodes. Candidates come from a coordinate search: each weight is nudged up
+// and down in turn, and the steps halve whenever a full pass finds nothing.
+//
+//     Tuner [--first D] [--deals N] [--validate V] [--threads T] [--nodes N] [--rounds R] [--start FILE] [--out FILE]
+//
+// The search fits the weights to its own batch, so the result is then scored
+// on the V deals that follow it, which it never saw. The tuned weights are
+// only written if they beat the starting ones there too; otherwise the
+// starting weights are; --validate 0 skips the check. Copy the file next to
+// the game as weights.txt to use them.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "field.h"
+#include "search_weights.h"
+#include "solver.h"
+
+struct TunerOptions {
+    std::uint64_t first_deal = 0;
+    std::uint64_t deals = 500;
+    std::uint64_t validation_deals = 500;
+    int threads = 0;
+    std::uint64_t max_nodes = 200'000;
+    int rounds = 20;
+    std::string start_path;
+    std::string out_path = "weights.txt";
+};
+
+struct Evaluation {
+    std::uint64_t solved = 0;
+    std::uint64_t unsolvable = 0;
+    std::uint64_t timeout = 0;
+    std::uint64_t solved_nodes = 0;
+    std::uint64_t nodes = 0;
+
+    bool is_better_than(const Evaluation &other) const {
+        if (solved != other.solved) {
+            return solved > other.solved;
+        }
+        return nodes < other.nodes;
+    }
+};
+
+static void print_usage() {
+    std::cerr << "usage: Tuner [--first D] [--deals N] [--validate V] [--threads T] [--nodes N] [--rounds R] [--start FILE] [--out FILE]\n";
+}
+
+static bool parse_options(int argc, char *argv[], TunerOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--first" && has_value) {
+            options.first_deal = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--deals" && has_value) {
+            options.deals = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--validate" && has_value) {
+            options.validation_deals = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--nodes" && has_value) {
+            options.max_nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rounds" && has_value) {
+            options.rounds = std::atoi(argv[++i]);
+        } else if (arg == "--start" && has_value) {
+            options.start_path = argv[++i];
+        } else if (arg == "--out" && has_value) {
+            options.out_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (options.threads <= 0) {
+        options.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    return true;
+}
+
+// Solves deals `first_deal` to `first_deal + deals - 1`. Only the node budget
+// limits a solve, so results do not depend on machine load and every
+// candidate is judged on exactly the same work.
+static Evaluation evaluate(const TunerOptions &options, std::uint64_t first_deal, std::uint64_t deals, const SearchWeights &weights) {
+    SolverLimits limits = {.max_nodes = options.max_nodes, .max_seconds = 1e9, .weights = weights};
+    std::atomic<std::uint64_t> next_deal = 0;
+    std::atomic<std::uint64_t> solved = 0;
+    std::atomic<std::uint64_t> unsolvable = 0;
+    std::atomic<std::uint64_t> timeout = 0;
+    std::atomic<std::uint64_t> solved_nodes = 0;
+    std::atomic<std::uint64_t> nodes = 0;
+
+    auto work = [&]() {
+        Solver solver(limits, 18);
+        Field field{empty_board};
+        for (std::uint64_t deal = next_deal++; deal < deals; deal = next_deal++) {
+            field.deal(first_deal + deal);
+            SolveResult result = solver.solve(field);
+            switch (result.status) {
+            case SolveStatus::solved:
+                solved++;
+                solved_nodes += result.nodes;
+                break;
+            case SolveStatus::unsolvable:
+                unsolvable++;
+                break;
+            case SolveStatus::timeout:
+                timeout++;
+                break;
+            }
+            nodes += result.nodes;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.threads; i++) {
+        threads.emplace_back(work);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return Evaluation{solved, unsolvable, timeout, solved_nodes, nodes};
+}
+
+static void print_weights(const SearchWeights &weights) {
+    for (const SearchWeightField &field : search_weight_fields) {
+        std::cout << ' ' << field.name << '=' << weights.*field.member;
+    }
+    std::cout << '\n';
+}
+
+static void print_evaluation(const Evaluation &evaluation) {
+    std::cout << std::fixed << std::setprecision(1)
+              << "solved " << evaluation.solved << ", unsolvable " << evaluation.unsolvable << ", timeout " << evaluation.timeout
+              << ", nodes " << evaluation.nodes << ", nodes per solve "
+              << (evaluation.solved ? double(evaluation.solved_nodes) / evaluation.solved : 0.0) << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    TunerOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    SearchWeights initial;
+    if (!options.start_path.empty() && !load_search_weights(options.start_path, initial)) {
+        std::cerr << "ERROR: Cannot read \"" << options.start_path << "\"\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SearchWeights best = initial;
+    Evaluation best_evaluation = evaluate(options, options.first_deal, options.deals, best);
+    std::cout << "start:";
+    print_weights(best);
+    std::cout << "       ";
+    print_evaluation(best_evaluation);
+
+    std::array<int, search_weight_fields.size()> steps;
+    steps.fill(16);
+    for (int round = 0; round < options.rounds; round++) {
+        bool improved = false;
+        for (size_t i = 0; i < search_weight_fields.size(); i++) {
+            for (int sign : {1, -1}) {
+                SearchWeights candidate = best;
+                candidate.*search_weight_fields[i].member += sign * steps[i];
+                Evaluation evaluation = evaluate(options, options.first_deal, options.deals, candidate);
+                if (!evaluation.is_better_than(best_evaluation)) {
+                    continue;
+                }
+
+                best = candidate;
+                best_evaluation = evaluation;
+                improved = true;
+                std::cout << "round " << round << ":";
+                print_weights(best);
+                std::cout << "       ";
+                print_evaluation(best_evaluation);
+                break;
+            }
+        }
+
+        if (!improved) {
+            if (std::all_of(steps.begin(), steps.end(), [](int step) { return step == 1; })) {
+                break;
+            }
+            for (int &step : steps) {
+                step = std::max(step / 2, 1);
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1) << "done in " << seconds << " s, best:";
+    print_weights(best);
+
+    if (options.validation_deals > 0) {
+        std::uint64_t first_held_out = options.first_deal + options.deals;
+        Evaluation initial_held_out = evaluate(options, first_held_out, options.validation_deals, initial);
+        Evaluation best_held_out = evaluate(options, first_held_out, options.validation_deals, best);
+        std::cout << "held out " << first_held_out << " to " << first_held_out + options.validation_deals - 1 << ":\n"
+                  << "  start: ";
+        print_evaluation(initial_held_out);
+        std::cout << "  best:  ";
+        print_evaluation(best_held_out);
+        if (!best_held_out.is_better_than(initial_held_out)) {
+            std::cout << "WARNING: Tuned weights do no better on the held-out deals, keeping the start weights\n";
+            best = initial;
+        }
+    }
+
+    if (!save_search_weights(options.out_path, best)) {
+        std::cerr << "ERROR: Cannot write \"" << options.out_path << "\"\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "deadlock.h"
+#include "field.h"
+#include "movegen.h"
+#include "yukon_env.h"
+
+static_assert(YUKON_ENV_OBSERVATION_SIZE == yukon_width * yukon_height + foundation_count);
+static_assert(YUKON_ENV_FACE_DOWN == hidden);
+static_assert(YUKON_ENV_ACTION_COUNT == yukon_width * yukon_height * (yukon_width + 1));
+static_assert(YUKON_ENV_MAX_LEGAL_ACTIONS == max_moves);
+
+static int encode_action(Move move) {
+    int to = move.kind == MoveKind::foundation ? yukon_width : move.to_col;
+    return (move.from_col * yukon_height + move.from_row) * (yukon_width + 1) + to;
+}
+
+static int foundation_cards(const Field &field) {
+    int cards = 0;
+    for (int suit = 0; suit < foundation_count; suit++) {
+        cards += field.foundation(suit).get_pip() * !field.foundation(suit).is_nil();
+    }
+    return cards;
+}
+
+// Threads that sit on a condition variable between batches, so a batch call
+// costs a wake-up rather than thread creation.
+class BatchPool {
+public:
+    explicit BatchPool(int threads) {
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back(&BatchPool::run, this);
+        }
+    }
+
+    ~BatchPool() {
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Calls body(i) for every i in [0, count), the caller taking a share.
+    void for_each(int count, const std::function<void(int)> &body) {
+        {
+            std::lock_guard lock(mutex);
+            job = &body;
+            job_count = count;
+            next_chunk = 0;
+            busy = static_cast<int>(workers.size());
+            generation++;
+        }
+        wake.notify_all();
+        work();
+
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&] { return busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    static constexpr int chunk_size = 64;
+
+    void run() {
+        std::uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) {
+                    return;
+                }
+                seen = generation;
+            }
+            work();
+            {
+                std::lock_guard lock(mutex);
+                busy--;
+            }
+            done.notify_one();
+        }
+    }
+
+    void work() {
+        while (true) {
+            int first;
+            {
+                std::lock_guard lock(mutex);
+                first = next_chunk;
+                next_chunk += chunk_size;
+            }
+            if (first >= job_count) {
+                return;
+            }
+            for (int i = first; i < std::min(first + chunk_size, job_count); i++) {
+                (*job)(i);
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)> *job = nullptr;
+    int job_count = 0;
+    int next_chunk = 0;
+    int busy = 0;
+    std::uint64_t generation = 0;
+    bool stop = false;
+};
+
+struct YukonEnv {
+    std::vector<Field> fields;
+    std::vector<std::int32_t> statuses;
+    BatchPool pool;
+
+    YukonEnv(int count, int threads)
+        : fields(static_cast<size_t>(count)),
+          statuses(static_cast<size_t>(count), YUKON_ENV_PLAYING),
+          pool(threads) {
+    }
+
+    void update_status(int index) {
+        Field &field = fields[index];
+        if (field.is_finished()) {
+            statuses[index] = YUKON_ENV_WON;
+            return;
+        }
+        MoveList moves;
+        MoveGen::generate(field, moves);
+        if (moves.size() == 0) {
+            statuses[index] = YUKON_ENV_STUCK;
+        } else if (is_visibly_dead(field)) {
+            statuses[index] = YUKON_ENV_LOST;
+        } else {
+            statuses[index] = YUKON_ENV_PLAYING;
+        }
+    }
+};
+
+extern "C" {
+
+YukonEnv *yukon_env_create(std::int32_t count, std::int32_t threads) {
+    if (count <= 0) {
+        return nullptr;
+    }
+    if (threads <= 0) {
+        threads = static_cast<std::int32_t>(std::thread::hardware_concurrency());
+    }
+    return new YukonEnv(count, std::max(threads, 1));
+}
+
+void yukon_env_destroy(YukonEnv *env) {
+    delete env;
+}
+
+std::int32_t yukon_env_count(const YukonEnv *env) {
+    return static_cast<std::int32_t>(env->fields.size());
+}
+
+void yukon_env_reset(YukonEnv *env, std::uint64_t first_seed) {
+    env->pool.for_each(yukon_env_count(env), [&](int i) {
+        env->fields[i].deal(first_seed + static_cast<std::uint64_t>(i));
+        env->update_status(i);
+    });
+}
+
+void yukon_env_reset_one(YukonEnv *env, std::int32_t index, std::uint64_t seed) {
+    env->fields[index].deal(seed);
+    env->update_status(index);
+}
+
+void yukon_env_observe(YukonEnv *env, std::int8_t *observations) {
+    env->pool.for_each(yukon_env_count(env), [&](int i) {
+        const Field &field = env->fields[i];
+        std::int8_t *out = observations + static_cast<size_t>(i) * YUKON_ENV_OBSERVATION_SIZE;
+        for (int col = 0; col < yukon_width; col++) {
+            for (int row = 0; row < yukon_height; row++) {
+                Card card = field.at(col, row);
+                *out++ = static_cast<std::int8_t>(card.is_nil() ? nil : card.is_hidden() ? hidden : card.get_raw());
+            }
+        }
+        for (int suit = 0; suit < foundation_count; suit++) {
+            *out++ = static_cast<std::int8_t>(field.foundation(suit).get_raw());
+        }
+    });
+}
+
+void yukon_env_legal_actions(YukonEnv *env, std::int32_t *actions, std::int32_t *counts) {
+    env->pool.for_each(yukon_env_count(env), [&](int i) {
+        std::int32_t *out = actions + static_cast<size_t>(i) * YUKON_ENV_MAX_LEGAL_ACTIONS;
+        counts[i] = 0;
+        if (env->statuses[i] == YUKON_ENV_WON) {
+            return;
+        }
+        MoveList moves;
+        MoveGen::generate(env->fields[i], moves);
+        for (Move move : moves) {
+            out[counts[i]++] = encode_action(move);
+        }
+    });
+}
+
+void yukon_env_step(YukonEnv *env, const std::int32_t *actions, float *rewards, std::int32_t *statuses) {
+    env->pool.for_each(yukon_env_count(env), [&](int i) {
+        rewards[i] = 0.0f;
+        if (env->statuses[i] == YUKON_ENV_PLAYING) {
+            Field &field = env->fields[i];
+            // Only actions the move generator produces are played, so a bad
+            // index can never corrupt the field.
+            MoveList moves;
+            MoveGen::generate(field, moves);
+            auto legal = std::find_if(moves.begin(), moves.end(), [&](Move move) {
+                return encode_action(move) == actions[i];
+            });
+            if (legal == moves.end()) {
+                rewards[i] = -1.0f;
+            } else {
+                int before = foundation_cards(field);
+                field.make(*legal);
+                rewards[i] = static_cast<float>(foundation_cards(field) - before);
+                env->update_status(i);
+            }
+        }
+        statuses[i] = env->statuses[i];
+    });
+}
+
+std::int32_t yukon_env_status(const YukonEnv *env, std::int32_t index) {
+    return env->statuses[index];
+}
+}
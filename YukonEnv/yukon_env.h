@@ -0,0 +1,86 @@
+/*
+ * Headless batched Yukon environment with a plain C ABI, for scripted and
+ * learned agents. One handle owns `count` independent games that are reset,
+ * observed and stepped together; batch calls are spread over a fixed pool of
+ * worker threads.
+ *
+ * Observation, per game, YUKON_ENV_OBSERVATION_SIZE signed bytes:
+ *   - 7 columns x 52 rows, column-major: 0..51 for a face-up card
+ *     (suit * 13 + pip - 1, suits in S H D C order), YUKON_ENV_FACE_DOWN for a
+ *     face-down card, -1 for an empty slot. Face-down cards are never
+ *     identified.
+ *   - 4 foundations: the top card, or -1 when empty.
+ *
+ * Actions are integers:
+ *   (from_col * 52 + from_row) * 8 + to
+ * where `to` is the destination column 0..6, or 7 to put the card on its
+ * foundation. The range from from_row up moves together.
+ *
+ * Game status: YUKON_ENV_PLAYING, YUKON_ENV_WON, YUKON_ENV_STUCK (no legal
+ * actions) or YUKON_ENV_LOST (a column can provably never be uncovered,
+ * whatever the face-down cards are, so the status tells an agent nothing the
+ * observation does not). A game keeps its status until it is reset.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifdef YUKON_ENV_EXPORTS
+#define YUKON_ENV_API __declspec(dllexport)
+#else
+#define YUKON_ENV_API __declspec(dllimport)
+#endif
+#else
+#define YUKON_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YUKON_ENV_OBSERVATION_SIZE (7 * 52 + 4)
+#define YUKON_ENV_FACE_DOWN 52
+#define YUKON_ENV_ACTION_COUNT (7 * 52 * 8)
+/* No position has more legal actions than this. */
+#define YUKON_ENV_MAX_LEGAL_ACTIONS 127
+
+#define YUKON_ENV_PLAYING 0
+#define YUKON_ENV_WON 1
+#define YUKON_ENV_STUCK 2
+#define YUKON_ENV_LOST 3
+
+typedef struct YukonEnv YukonEnv;
+
+/* `threads` <= 0 uses every hardware thread. Returns NULL if count <= 0. */
+YUKON_ENV_API YukonEnv *yukon_env_create(int32_t count, int32_t threads);
+YUKON_ENV_API void yukon_env_destroy(YukonEnv *env);
+YUKON_ENV_API int32_t yukon_env_count(const YukonEnv *env);
+
+/* Game i gets deal number first_seed + i, the same numbering as Field(deal). */
+YUKON_ENV_API void yukon_env_reset(YukonEnv *env, uint64_t first_seed);
+YUKON_ENV_API void yukon_env_reset_one(YukonEnv *env, int32_t index, uint64_t seed);
+
+/* observations: count * YUKON_ENV_OBSERVATION_SIZE bytes. */
+YUKON_ENV_API void yukon_env_observe(YukonEnv *env, int8_t *observations);
+
+/*
+ * actions: count * YUKON_ENV_MAX_LEGAL_ACTIONS entries; game i writes its
+ * legal actions from actions[i * YUKON_ENV_MAX_LEGAL_ACTIONS] and their number
+ * to counts[i].
+ */
+YUKON_ENV_API void yukon_env_legal_actions(YukonEnv *env, int32_t *actions, int32_t *counts);
+
+/*
+ * Plays actions[i] in every game still playing. rewards[i] is the number of
+ * cards the action put on the foundations, or -1 for an illegal action, which
+ * leaves the game unchanged. statuses[i] receives the status afterwards.
+ * Finished games ignore their action and get a reward of 0.
+ */
+YUKON_ENV_API void yukon_env_step(YukonEnv *env, const int32_t *actions, float *rewards, int32_t *statuses);
+
+YUKON_ENV_API int32_t yukon_env_status(const YukonEnv *env, int32_t index);
+
+#ifdef __cplusplus
+}
+#endif